@@ -0,0 +1,34 @@
+#ifndef ARRAYVIEW_H
+#define ARRAYVIEW_H
+
+#include <cstddef>
+
+/**
+ * @brief Vista de solo lectura sobre un arreglo contiguo que pertenece a otro
+ * objeto (un std::vector, una región de memoria mapeada, etc.).
+ */
+template <typename T>
+class ArrayView {
+private:
+    const T* m_data = nullptr;
+    std::size_t m_size = 0;
+
+public:
+    ArrayView() = default;
+    ArrayView(const T* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    template <typename Container>
+    ArrayView(const Container& container)
+        : m_data(container.data()), m_size(container.size()) {}
+
+    const T& operator[](std::size_t i) const { return m_data[i]; }
+
+    const T* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+};
+
+#endif  // ARRAYVIEW_H
@@ -0,0 +1,174 @@
+#ifndef COMPRESSEDGRAPH_H
+#define COMPRESSEDGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "csrgraph.h"
+#include "neighbors.h"
+#include "reachability.h"
+
+/**
+ * @brief Grafo inmutable con la lista de adyacencia comprimida, para grafos
+ * que apenas caben en memoria.
+ *
+ * Los destinos de cada fila están ordenados y se guardan como diferencias
+ * codificadas en varint (LEB128): el primero respecto del propio nodo (en
+ * zigzag, porque puede ser negativo) y los siguientes respecto del anterior.
+ * Los pesos se guardan, desplazados por el peso mínimo, en un arreglo de bits
+ * con el ancho justo para el mayor de ellos.
+ *
+ * Los inicios de fila (en aristas y en bytes) se guardan en dos niveles: un
+ * valor absoluto de 64 bits por bloque de `block_size` nodos y, por nodo, un
+ * desplazamiento de 32 bits desde el inicio de su bloque.
+ *
+ * El grafo se construye fila por fila desde otro grafo (un Graph recién
+ * leído o un CsrGraph, que puede estar mapeado desde un snapshot), sin
+ * armar antes una copia en formato CSR. Si el CsrGraph ya tiene su índice
+ * de alcanzabilidad, el grafo comprimido lo comparte.
+ */
+class CompressedGraph {
+public:
+    using weight_type = CsrGraph::weight_type;
+
+    class NeighborRange {
+    public:
+        class iterator {
+        private:
+            const CompressedGraph* m_graph;
+            const std::uint8_t* m_bytes;
+            std::uint64_t m_edge;
+            std::uint64_t m_remaining;
+            NodeId m_target;
+            bool m_first;
+
+            void decode();
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::pair<NodeId, weight_type>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            iterator(const CompressedGraph* graph, NodeId from,
+                     const std::uint8_t* bytes, std::uint64_t edge,
+                     std::uint64_t remaining);
+
+            value_type operator*() const {
+                return {m_target, m_graph->weight_at(m_edge)};
+            }
+
+            iterator& operator++() {
+                ++m_edge;
+                --m_remaining;
+                decode();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto ret = *this;
+                ++*this;
+                return ret;
+            }
+
+            bool operator==(const iterator& other) const {
+                return m_remaining == other.m_remaining;
+            }
+
+            bool operator!=(const iterator& other) const {
+                return m_remaining != other.m_remaining;
+            }
+        };
+
+    private:
+        const CompressedGraph* m_graph;
+        NodeId m_from;
+
+    public:
+        NeighborRange(const CompressedGraph* graph, NodeId from)
+            : m_graph(graph), m_from(from) {}
+
+        iterator begin() const;
+        iterator end() const;
+
+        std::size_t size() const;
+        bool empty() const { return size() == 0; }
+    };
+
+private:
+    static constexpr std::size_t block_size = 64;
+
+    /**
+     * @brief Inicio de una fila, relativo al inicio de su bloque.
+     */
+    struct RowOffset {
+        std::uint32_t edge;
+        std::uint32_t byte;
+    };
+
+    /**
+     * @brief Inicio absoluto de un bloque de filas.
+     */
+    struct BlockOffset {
+        std::uint64_t edge;
+        std::uint64_t byte;
+    };
+
+    std::vector<BlockOffset> m_blocks;
+    std::vector<RowOffset> m_rows;
+    std::vector<std::uint8_t> m_targets;
+
+    std::vector<std::uint64_t> m_weights;
+    unsigned m_weight_bits;
+    weight_type m_min_weight;
+
+    std::vector<int> m_heuristics;
+    std::vector<std::uint64_t> m_name_offsets;
+    std::vector<char> m_names;
+    std::vector<NodeId> m_name_order;
+
+    NodeId m_start, m_end;
+
+    std::shared_ptr<const ReachabilityIndex> m_reachability;
+
+    std::uint64_t edge_offset(NodeId node) const;
+    std::uint64_t byte_offset(NodeId node) const;
+    void add_row_offset(std::uint64_t edge, std::uint64_t byte);
+
+    weight_type weight_at(std::uint64_t edge) const;
+
+    bool check_node(NodeId node) const;
+
+public:
+    template <typename G>
+    explicit CompressedGraph(const G& graph);
+
+    NodeId start_id() const;
+    NodeId end_id() const;
+
+    std::size_t vertex_count() const;
+    std::size_t edge_count() const;
+
+    NodeId node_id(std::string_view node) const;
+    std::string_view node_name(NodeId node) const;
+
+    int get_heuristic(NodeId node) const;
+    weight_type get_cost(NodeId from, NodeId to) const;
+
+    NeighborRange neighbors(NodeId from) const;
+
+    bool are_connected(NodeId from, NodeId to) const;
+
+    void build_reachability();
+    bool has_reachability() const;
+    const ReachabilityIndex& reachability() const;
+};
+
+#endif  // COMPRESSEDGRAPH_H
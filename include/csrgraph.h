@@ -0,0 +1,186 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "arrayview.h"
+#include "edgeindex.h"
+#include "graph.h"
+#include "neighbors.h"
+#include "reachability.h"
+#include "weight.h"
+
+struct SnapshotSource;
+
+/**
+ * @brief Vista inmutable de un grafo en formato CSR (compressed sparse row).
+ *
+ * Las aristas que salen del nodo `u` ocupan las posiciones
+ * `[offsets[u], offsets[u + 1])` de los arreglos `targets` y `weights`, de
+ * modo que recorrer los vecinos de un nodo es un barrido lineal de memoria.
+ * Cada fila está ordenada por destino, lo que permite buscar una arista con
+ * búsqueda binaria; las filas de grado alto además se indexan en una tabla
+ * hash plana (FlatEdgeIndex), que se guarda en los snapshots.
+ *
+ * En un grafo no dirigido cada arista aparece en la fila de sus dos extremos,
+ * y esa misma adyacencia sirve para recorrer las aristas entrantes. Guardar
+ * la arista una sola vez no ahorraría memoria: para recorrerla desde el otro
+ * extremo haría falta un índice de aristas entrantes con una entrada por
+ * arista, que es justamente la otra mitad de las filas. Así, además, los
+ * vecinos de un nodo siguen siendo un solo tramo contiguo. En un grafo
+ * dirigido las aristas entrantes requieren una adyacencia inversa, que
+ * se construye solo si se pide (ver build_reverse). Lo mismo ocurre con el
+ * índice de alcanzabilidad (ver build_reachability), que además se guarda en
+ * los snapshots.
+ *
+ * Los arreglos no se guardan directamente en el objeto, sino en un
+ * almacenamiento compartido (vectores propios o un archivo mapeado en
+ * memoria), por lo que copiar un CsrGraph no copia el grafo. La única parte
+ * modificable son los pesos (ver update_weights), que se copian aparte la
+ * primera vez que se modifican.
+ *
+ * El tipo de los pesos es un parámetro: un tipo angosto (p. ej. uint16_t)
+ * reduce la memoria que se recorre al relajar aristas, y uno de punto
+ * flotante permite pesos métricos. `CsrGraph` usa int, como Graph.
+ */
+template <typename W>
+class BasicCsrGraph {
+public:
+    using weight_type = W;
+
+    /**
+     * @brief Arreglos con los que se construye un CsrGraph. Los nombres se
+     * guardan concatenados en `names`; el nombre del nodo `u` ocupa
+     * `[name_offsets[u], name_offsets[u + 1])`. En un grafo no dirigido
+     * cada arista debe aparecer en la fila de sus dos extremos. Las
+     * coordenadas son opcionales: `coordinates` queda vacío o tiene una
+     * entrada por nodo.
+     */
+    struct Arrays {
+        std::vector<std::uint64_t> offsets;
+        std::vector<NodeId> targets;
+        std::vector<weight_type> weights;
+        std::vector<int> heuristics;
+        std::vector<std::uint64_t> name_offsets;
+        std::vector<char> names;
+        std::vector<Point> coordinates;
+        NodeId start = Graph::invalid_node;
+        NodeId end = Graph::invalid_node;
+        GraphMode mode = GraphMode::directed;
+    };
+
+    /**
+     * @brief Cambio del peso de una arista.
+     */
+    struct WeightUpdate {
+        NodeId from;
+        NodeId to;
+        weight_type weight;
+    };
+
+private:
+    /**
+     * @brief Adyacencia inversa de un grafo dirigido: la fila de `v` contiene
+     * los orígenes de las aristas que llegan a `v`, ordenados.
+     */
+    struct ReverseArrays {
+        std::vector<std::uint64_t> offsets;
+        std::vector<NodeId> sources;
+        std::vector<weight_type> weights;
+    };
+
+    std::shared_ptr<const void> m_storage;
+    GraphMode m_mode = GraphMode::directed;
+
+    ArrayView<std::uint64_t> m_offsets;
+    ArrayView<NodeId> m_targets;
+    ArrayView<weight_type> m_weights;
+    std::shared_ptr<std::vector<weight_type>> m_updated_weights;
+    std::uint64_t m_weight_version = 0;
+    FlatEdgeIndex m_hub_edges;
+    std::shared_ptr<ReverseArrays> m_reverse;
+    std::shared_ptr<const ReachabilityIndex> m_reachability;
+
+    ArrayView<int> m_heuristics;
+    ArrayView<std::uint64_t> m_name_offsets;
+    ArrayView<char> m_names;
+    ArrayView<NodeId> m_name_order;
+    ArrayView<Point> m_coordinates;
+
+    NodeId m_start = Graph::invalid_node, m_end = Graph::invalid_node;
+
+    BasicCsrGraph() = default;
+
+    static Arrays make_arrays(const Graph& graph);
+    void build_hub_index();
+    bool is_symmetric() const;
+
+    bool check_node(NodeId node) const;
+
+    std::optional<std::size_t> find_edge(NodeId from, NodeId to) const;
+
+    template <typename U>
+    friend void write_snapshot(const BasicCsrGraph<U>& graph,
+                               const std::string& path,
+                               const SnapshotSource& source);
+    template <typename U>
+    friend BasicCsrGraph<U> read_snapshot(const std::string& path,
+                                          bool verify);
+
+public:
+    explicit BasicCsrGraph(const Graph& graph);
+    explicit BasicCsrGraph(Arrays arrays);
+
+    GraphMode mode() const;
+
+    NodeId start_id() const;
+    NodeId end_id() const;
+
+    std::size_t vertex_count() const;
+    std::size_t edge_count() const;
+
+    NodeId node_id(std::string_view node) const;
+    std::string_view node_name(NodeId node) const;
+
+    int get_heuristic(NodeId node) const;
+    bool has_coordinates() const;
+    Point get_coordinates(NodeId node) const;
+    weight_type get_cost(NodeId from, NodeId to) const;
+
+    BasicNeighborRange<weight_type> neighbors(NodeId from) const;
+
+    void build_reverse();
+    bool has_reverse() const;
+    BasicNeighborRange<weight_type> in_neighbors(NodeId to) const;
+
+    void build_reachability();
+    bool has_reachability() const;
+    const ReachabilityIndex& reachability() const;
+
+    bool are_connected(NodeId from, NodeId to) const;
+
+    std::uint64_t update_weights(const std::vector<WeightUpdate>& updates);
+    std::uint64_t weight_version() const;
+
+    ArrayView<std::uint64_t> offsets() const;
+    ArrayView<NodeId> targets() const;
+    ArrayView<weight_type> weights() const;
+    ArrayView<int> heuristics() const;
+    ArrayView<std::uint64_t> name_offsets() const;
+    ArrayView<char> names() const;
+    ArrayView<NodeId> name_order() const;
+    ArrayView<Point> coordinates() const;
+};
+
+using CsrGraph = BasicCsrGraph<int>;
+
+template <typename W>
+BasicCsrGraph<W> convert_weights(const CsrGraph& graph);
+
+#endif  // CSRGRAPH_H
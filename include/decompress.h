@@ -0,0 +1,62 @@
+#ifndef DECOMPRESS_H
+#define DECOMPRESS_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Formato de compresión de un archivo.
+ */
+enum class Compression { none, gzip, zstd };
+
+Compression detect_compression(const std::string& path);
+
+/**
+ * @brief std::streambuf que entrega el contenido descomprimido de un archivo.
+ *
+ * La descompresión corre en un hilo propio, que deja bloques en una cola de
+ * tamaño acotado; quien lee toma los bloques a medida que los necesita, de
+ * modo que descomprimir e interpretar el texto se solapan y nunca se guarda
+ * en memoria más que unos pocos bloques. Si el archivo está dañado, la
+ * lectura lanza la excepción del hilo de descompresión (un std::istream la
+ * propaga si tiene activada la excepción de badbit).
+ */
+class DecompressStreambuf : public std::streambuf {
+private:
+    static constexpr std::size_t block_size = 1 << 16;
+    static constexpr std::size_t max_blocks = 16;
+
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+    std::condition_variable m_space;
+    std::deque<std::vector<char>> m_blocks;
+    std::vector<char> m_current;
+    bool m_done = false;
+    bool m_closed = false;
+    std::exception_ptr m_error;
+
+    std::thread m_thread;
+
+    bool push(std::vector<char> block);
+    void produce(std::ifstream in, const std::string& path, Compression kind);
+
+protected:
+    int_type underflow() override;
+
+public:
+    DecompressStreambuf(const std::string& path, Compression kind);
+    ~DecompressStreambuf() override;
+
+    DecompressStreambuf(const DecompressStreambuf&) = delete;
+    DecompressStreambuf& operator=(const DecompressStreambuf&) = delete;
+};
+
+#endif  // DECOMPRESS_H
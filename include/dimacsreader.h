@@ -0,0 +1,13 @@
+#ifndef DIMACSREADER_H
+#define DIMACSREADER_H
+
+#include <string>
+
+#include "csrgraph.h"
+#include "graph.h"
+
+CsrGraph read_dimacs(const std::string& gr_path, const std::string& co_path,
+                     const std::string& start, const std::string& end,
+                     GraphMode mode);
+
+#endif  // DIMACSREADER_H
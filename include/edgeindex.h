@@ -0,0 +1,167 @@
+#ifndef EDGEINDEX_H
+#define EDGEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "arrayview.h"
+#include "neighbors.h"
+
+/**
+ * @brief Tabla hash (origen, destino) -> posición de la arista. Solo se usa
+ * para los nodos de grado alto; en el resto basta con recorrer o hacer
+ * búsqueda binaria sobre su lista de adyacencia.
+ */
+class EdgeIndex {
+private:
+    std::unordered_map<std::uint64_t, std::size_t> m_positions;
+
+    static std::uint64_t key(NodeId from, NodeId to) {
+        return (static_cast<std::uint64_t>(from) << 32) | to;
+    }
+
+public:
+    // Grado a partir del cual las aristas de un nodo se indexan en la tabla.
+    static constexpr std::size_t hub_degree = 32;
+
+    /**
+     * @brief Registra la posición de una arista. Si la arista ya estaba
+     * indexada se conserva la primera posición, igual que en un recorrido
+     * lineal de la lista de adyacencia.
+     */
+    void insert(NodeId from, NodeId to, std::size_t position) {
+        m_positions.emplace(key(from, to), position);
+    }
+
+    /**
+     * @brief Busca la posición de una arista.
+     * @return La posición de la arista, o std::nullopt si no está indexada.
+     */
+    std::optional<std::size_t> find(NodeId from, NodeId to) const {
+        const auto it = m_positions.find(key(from, to));
+        if (it == std::cend(m_positions)) {
+            return std::nullopt;
+        }
+
+        return it->second;
+    }
+};
+
+/**
+ * @brief Versión inmutable de EdgeIndex para CsrGraph: una tabla con
+ * direccionamiento abierto (sondeo lineal) en un arreglo plano de ranuras.
+ * Como no tiene punteros, se puede guardar en un snapshot y mapearla sin
+ * reconstruirla. Igual que CsrGraph, las ranuras están en un almacenamiento
+ * compartido, así que copiar el índice no las copia.
+ */
+class FlatEdgeIndex {
+public:
+    /**
+     * @brief Ranura de la tabla. Una ranura libre tiene la clave
+     * `empty_key`, que no corresponde a ninguna arista porque su origen
+     * sería Graph::invalid_node.
+     */
+    struct Slot {
+        std::uint64_t key;
+        std::uint64_t position;
+    };
+
+    static constexpr std::uint64_t empty_key = ~std::uint64_t{0};
+
+private:
+    std::shared_ptr<const void> m_storage;
+    ArrayView<Slot> m_slots;
+
+    static std::uint64_t key(NodeId from, NodeId to) {
+        return (static_cast<std::uint64_t>(from) << 32) | to;
+    }
+
+    // Mezcla los bits de la clave: el origen está en los bits altos, que la
+    // máscara de la tabla descartaría.
+    static std::uint64_t hash(std::uint64_t key) {
+        key *= 0x9e3779b97f4a7c15;
+        return key ^ (key >> 32);
+    }
+
+public:
+    FlatEdgeIndex() = default;
+
+    /**
+     * @brief Crea el índice sobre ranuras que pertenecen a `storage`, por
+     * ejemplo un snapshot mapeado en memoria. El número de ranuras debe ser
+     * 0 o una potencia de 2.
+     */
+    FlatEdgeIndex(ArrayView<Slot> slots, std::shared_ptr<const void> storage)
+        : m_storage(std::move(storage)), m_slots(slots) {}
+
+    /**
+     * @brief Construye el índice con las aristas `(from, targets[i])` de las
+     * posiciones `[first, last)` de cada fila, dadas como tripletas (origen,
+     * primera posición, última posición). Si una arista se repite se
+     * conserva la primera posición, igual que en EdgeIndex.
+     */
+    template <typename Rows>
+    static FlatEdgeIndex build(const Rows& rows, ArrayView<NodeId> targets) {
+        std::uint64_t count = 0;
+        for (const auto& [from, first, last] : rows) {
+            count += last - first;
+        }
+
+        // La tabla queda a lo más a la mitad de su capacidad.
+        std::uint64_t size = count == 0 ? 0 : 1;
+        while (size < 2 * count) {
+            size *= 2;
+        }
+
+        auto slots = std::make_shared<std::vector<Slot>>(
+            size, Slot{empty_key, 0});
+        for (const auto& [from, first, last] : rows) {
+            for (auto i = first; i < last; ++i) {
+                const auto k = key(from, targets[i]);
+                auto slot = hash(k) & (size - 1);
+                while ((*slots)[slot].key != empty_key &&
+                       (*slots)[slot].key != k) {
+                    slot = (slot + 1) & (size - 1);
+                }
+
+                if ((*slots)[slot].key == empty_key) {
+                    (*slots)[slot] = {k, i};
+                }
+            }
+        }
+
+        const ArrayView<Slot> view(*slots);
+        return FlatEdgeIndex(view, std::move(slots));
+    }
+
+    /**
+     * @brief Busca la posición de una arista.
+     * @return La posición de la arista, o std::nullopt si no está indexada.
+     */
+    std::optional<std::size_t> find(NodeId from, NodeId to) const {
+        if (m_slots.empty()) {
+            return std::nullopt;
+        }
+
+        const auto k = key(from, to);
+        const auto mask = m_slots.size() - 1;
+        for (auto slot = hash(k) & mask;; slot = (slot + 1) & mask) {
+            if (m_slots[slot].key == k) {
+                return m_slots[slot].position;
+            }
+
+            if (m_slots[slot].key == empty_key) {
+                return std::nullopt;
+            }
+        }
+    }
+
+    ArrayView<Slot> slots() const { return m_slots; }
+};
+
+#endif  // EDGEINDEX_H
@@ -3,50 +3,126 @@
 
 #include <algorithm>
 #include <cstddef>
-#include <list>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <optional>
 #include <set>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "edgeindex.h"
+#include "neighbors.h"
+
+/**
+ * @brief Tipo de grafo. En un grafo no dirigido cada arista se puede recorrer
+ * en ambos sentidos.
+ */
+enum class GraphMode { directed, undirected };
+
 struct GraphNode {
     std::string name;
     int heuristic;
 };
 
+/**
+ * @brief Coordenadas de un nodo en el plano (o longitud y latitud).
+ */
+struct Point {
+    double x;
+    double y;
+};
+
 class Graph {
+    template <typename W>
+    friend class BasicCsrGraph;
+
+public:
+    using weight_type = int;
+
+    static constexpr NodeId invalid_node = std::numeric_limits<NodeId>::max();
+
 private:
-    std::list<GraphNode> m_nodes;
-    std::unordered_map<std::string, std::vector<std::pair<std::string, int>>>
-        m_adj_list;
-    std::string m_start, m_end;
+    // Los nodos están en un std::deque para que agregar uno no mueva a los
+    // demás: las claves de `m_node_ids` son vistas de los nombres guardados
+    // en `m_nodes`, así que buscar un nombre no lo copia.
+    std::deque<GraphNode> m_nodes;
+    std::unordered_map<std::string_view, NodeId> m_node_ids;
+
+    // Los nombres numéricos se resuelven con una tabla indexada por su valor,
+    // sin pasar por `m_node_ids`. Solo se agregan a la tabla los valores
+    // cercanos al número de nodos, para que unos pocos nombres numéricos
+    // grandes no la hagan crecer sin límite; esos quedan en `m_node_ids`, y
+    // `m_min_hashed_numeric` es el menor de ellos.
+    std::vector<NodeId> m_numeric_ids;
+    std::uint64_t m_min_hashed_numeric =
+        std::numeric_limits<std::uint64_t>::max();
+    std::vector<std::vector<NodeId>> m_adj_targets;
+    std::vector<std::vector<int>> m_adj_weights;
+    EdgeIndex m_hub_edges;
+    std::size_t m_edge_count = 0;
+    GraphMode m_mode = GraphMode::directed;
+    NodeId m_start = invalid_node, m_end = invalid_node;
+
+    static std::optional<std::uint64_t> numeric_name(std::string_view name);
+    std::optional<NodeId> find_node(std::string_view name) const;
+    bool check_node(std::string_view node) const;
+    bool check_node(NodeId node) const;
 
-    bool check_node(const std::string& node) const;
+    std::optional<std::size_t> find_edge(NodeId from, NodeId to) const;
+    void append_edge(NodeId from, NodeId to, int weight);
+    void index_names();
 
 public:
-    void add_node(const GraphNode& node);
+    explicit Graph(GraphMode mode = GraphMode::directed);
+    Graph(const Graph& other);
+    Graph(Graph&&) = default;
+    Graph& operator=(const Graph& other);
+    Graph& operator=(Graph&&) = default;
+
+    GraphMode mode() const;
+
+    NodeId add_node(GraphNode node);
     void add_edge(const std::string& from, const std::string& to, int weight);
+    void add_edge(NodeId from, NodeId to, int weight);
 
     void set_start(const std::string& start);
+    void set_start(NodeId start);
     void set_end(const std::string& end);
+    void set_end(NodeId end);
 
-    GraphNode start() const;
-    GraphNode end() const;
+    const GraphNode& start() const;
+    const GraphNode& end() const;
+    NodeId start_id() const;
+    NodeId end_id() const;
 
     std::size_t vertex_count() const;
     std::size_t edge_count() const;
 
+    NodeId node_id(std::string_view node) const;
+    const std::string& node_name(NodeId node) const;
+
     int get_heuristic(const std::string& node) const;
+    int get_heuristic(NodeId node) const;
     int get_cost(const std::string& from, const std::string& to) const;
+    int get_cost(NodeId from, NodeId to) const;
 
-    GraphNode get_node(const std::string& node) const;
+    const GraphNode& get_node(const std::string& node) const;
+    const GraphNode& get_node(NodeId node) const;
     std::set<std::string> get_nodes() const;
     std::set<std::tuple<std::string, std::string, int>> get_edges() const;
     std::set<std::pair<std::string, int>> get_neighbors(
         const std::string& from) const;
+    std::set<std::pair<NodeId, int>> get_neighbors(NodeId from) const;
+    NeighborRange neighbors(NodeId from) const;
 
     bool are_connected(const std::string& from, const std::string& to) const;
+    bool are_connected(NodeId from, NodeId to) const;
 };
 
 #endif  // GRAPH_H
@@ -0,0 +1,35 @@
+#ifndef GRAPHCACHE_H
+#define GRAPHCACHE_H
+
+#include <optional>
+#include <string>
+
+#include "csrgraph.h"
+#include "graph.h"
+#include "snapshot.h"
+
+/**
+ * @brief Caché binaria de un grafo en formato de texto. La caché es un
+ * snapshot guardado junto al archivo (`<archivo>.bin`) que registra el
+ * tamaño, la fecha de modificación y un hash del contenido del texto; si
+ * alguno cambia, la caché se descarta y se vuelve a generar.
+ */
+class GraphCache {
+private:
+    std::string m_path;
+    std::string m_cache_path;
+    SnapshotSource m_source;
+    bool m_hashed = false;
+
+    void hash_source();
+
+public:
+    explicit GraphCache(const std::string& path);
+
+    const std::string& cache_path() const;
+
+    std::optional<CsrGraph> load(GraphMode mode);
+    bool store(const CsrGraph& graph);
+};
+
+#endif  // GRAPHCACHE_H
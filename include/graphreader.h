@@ -1,27 +1,30 @@
 #ifndef GRAPHREADER_H
 #define GRAPHREADER_H
 
+#include <istream>
+#include <memory>
 #include <string>
-#include <unordered_map>
-#include <vector>
 
+#include "csrgraph.h"
 #include "graph.h"
 
 class GraphReader {
 private:
-    std::vector<std::string> m_lines;
+    std::string m_source;
 
-    Graph m_graph;
+    std::shared_ptr<Graph> m_graph;
 
-    void read_file(std::istream& path);
-
-    void make_graph();
+    void make_graph(std::istream& infile, GraphMode mode);
 
 public:
-    GraphReader();
-    explicit GraphReader(const std::string& path);
+    explicit GraphReader(GraphMode mode = GraphMode::directed);
+    explicit GraphReader(const std::string& path,
+                         GraphMode mode = GraphMode::directed);
 
-    Graph get_graph() const;
+    std::shared_ptr<const Graph> get_graph() const;
 };
 
+CsrGraph read_graph_parallel(const std::string& path, GraphMode mode,
+                             unsigned threads);
+
 #endif  // GRAPHREADER_H
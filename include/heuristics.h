@@ -0,0 +1,184 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "arrayview.h"
+#include "graph.h"
+#include "neighbors.h"
+
+/*
+ * Heurísticas para los solvers informados (A* y greedy). Cada heurística es
+ * un functor que se pasa al solver como parámetro de plantilla, de modo que
+ * la llamada se resuelve en tiempo de compilación y se puede expandir en
+ * línea. Todas ofrecen dos formas de evaluación:
+ *
+ *   h(node)                    valor para un nodo
+ *   h(nodes, count, out)       valores para `count` nodos, en `out`
+ *
+ * La segunda recorre los nodos en un ciclo sin dependencias entre
+ * iteraciones, que el compilador puede vectorizar.
+ */
+
+/**
+ * @brief Heurística leída del archivo de entrada. Solo es válida para el
+ * destino que indica el archivo.
+ */
+template <typename G>
+class FileHeuristic {
+private:
+    const G* m_graph;
+
+public:
+    using value_type = int;
+
+    explicit FileHeuristic(const G& graph) : m_graph(&graph) {}
+
+    value_type operator()(NodeId node) const {
+        return m_graph->get_heuristic(node);
+    }
+
+    void operator()(const NodeId* nodes, std::size_t count,
+                    value_type* out) const {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = m_graph->get_heuristic(nodes[i]);
+        }
+    }
+};
+
+/**
+ * @brief Coordenadas de los nodos, guardadas como dos arreglos separados (x e
+ * y) para que las heurísticas las lean en forma contigua. Copiar el objeto
+ * no copia los arreglos.
+ */
+class Coordinates {
+private:
+    std::shared_ptr<const std::vector<double>> m_x;
+    std::shared_ptr<const std::vector<double>> m_y;
+
+public:
+    explicit Coordinates(ArrayView<Point> points) {
+        auto x = std::make_shared<std::vector<double>>();
+        auto y = std::make_shared<std::vector<double>>();
+        x->reserve(points.size());
+        y->reserve(points.size());
+
+        for (const auto& point : points) {
+            x->push_back(point.x);
+            y->push_back(point.y);
+        }
+
+        m_x = std::move(x);
+        m_y = std::move(y);
+    }
+
+    const double* x() const { return m_x->data(); }
+    const double* y() const { return m_y->data(); }
+    std::size_t size() const { return m_x->size(); }
+};
+
+/**
+ * @brief Base de las heurísticas geométricas: guarda las coordenadas, las del
+ * destino y el factor que convierte distancias en unidades de peso. Para que
+ * A* encuentre el camino óptimo, la distancia multiplicada por `scale` no
+ * debe superar el costo real de ningún camino.
+ */
+template <typename Derived>
+class GeometricHeuristic {
+protected:
+    Coordinates m_points;
+    double m_target_x;
+    double m_target_y;
+    double m_scale;
+
+    GeometricHeuristic(const Coordinates& points, NodeId target, double scale)
+        : m_points(points),
+          m_target_x(points.x()[target]),
+          m_target_y(points.y()[target]),
+          m_scale(scale) {}
+
+public:
+    using value_type = double;
+
+    value_type operator()(NodeId node) const {
+        return m_scale * static_cast<const Derived&>(*this).distance(
+                             m_points.x()[node], m_points.y()[node]);
+    }
+
+    void operator()(const NodeId* nodes, std::size_t count,
+                    value_type* out) const {
+        const auto& self = static_cast<const Derived&>(*this);
+        const auto* x = m_points.x();
+        const auto* y = m_points.y();
+
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = m_scale * self.distance(x[nodes[i]], y[nodes[i]]);
+        }
+    }
+};
+
+/**
+ * @brief Distancia euclidiana al destino.
+ */
+class EuclideanHeuristic : public GeometricHeuristic<EuclideanHeuristic> {
+public:
+    EuclideanHeuristic(const Coordinates& points, NodeId target,
+                       double scale = 1)
+        : GeometricHeuristic(points, target, scale) {}
+
+    double distance(double x, double y) const {
+        const auto dx = x - m_target_x;
+        const auto dy = y - m_target_y;
+
+        return std::sqrt(dx * dx + dy * dy);
+    }
+};
+
+/**
+ * @brief Distancia Manhattan al destino, para grafos en grilla.
+ */
+class ManhattanHeuristic : public GeometricHeuristic<ManhattanHeuristic> {
+public:
+    ManhattanHeuristic(const Coordinates& points, NodeId target,
+                       double scale = 1)
+        : GeometricHeuristic(points, target, scale) {}
+
+    double distance(double x, double y) const {
+        return std::abs(x - m_target_x) + std::abs(y - m_target_y);
+    }
+};
+
+/**
+ * @brief Distancia sobre la superficie de la Tierra (fórmula del haversine),
+ * en metros. Las coordenadas son la longitud (x) y la latitud (y), en grados.
+ */
+class HaversineHeuristic : public GeometricHeuristic<HaversineHeuristic> {
+private:
+    static constexpr double earth_radius = 6371000.0;
+    static constexpr double radians_per_degree = 3.14159265358979323846 / 180;
+
+    double m_target_cos_lat;
+
+public:
+    HaversineHeuristic(const Coordinates& points, NodeId target,
+                       double scale = 1)
+        : GeometricHeuristic(points, target, scale),
+          m_target_cos_lat(std::cos(m_target_y * radians_per_degree)) {}
+
+    double distance(double lon, double lat) const {
+        const auto sin_dlat =
+            std::sin((lat - m_target_y) * radians_per_degree / 2);
+        const auto sin_dlon =
+            std::sin((lon - m_target_x) * radians_per_degree / 2);
+        const auto cos_lat = std::cos(lat * radians_per_degree);
+        const auto a = sin_dlat * sin_dlat +
+                       cos_lat * m_target_cos_lat * sin_dlon * sin_dlon;
+
+        return 2 * earth_radius * std::asin(std::sqrt(std::fmin(a, 1.0)));
+    }
+};
+
+#endif  // HEURISTICS_H
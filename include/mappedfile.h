@@ -0,0 +1,27 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief Archivo mapeado en memoria en modo de solo lectura. La región se
+ * libera al destruir el objeto.
+ */
+class MappedFile {
+private:
+    const char* m_data;
+    std::size_t m_size;
+
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const;
+    std::size_t size() const;
+};
+
+#endif  // MAPPEDFILE_H
@@ -0,0 +1,79 @@
+#ifndef NEIGHBORS_H
+#define NEIGHBORS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+using NodeId = std::uint32_t;
+
+/**
+ * @brief Vista sobre los vecinos de un nodo. No copia ni reserva memoria:
+ * recorre en paralelo un arreglo de destinos y uno de pesos que pertenecen al
+ * grafo, entregando pares (vecino, peso).
+ */
+template <typename W>
+class BasicNeighborRange {
+public:
+    class iterator {
+    private:
+        const NodeId* m_target;
+        const W* m_weight;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<NodeId, W>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        iterator(const NodeId* target, const W* weight)
+            : m_target(target), m_weight(weight) {}
+
+        value_type operator*() const { return {*m_target, *m_weight}; }
+
+        iterator& operator++() {
+            ++m_target;
+            ++m_weight;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        bool operator==(const iterator& other) const {
+            return m_target == other.m_target;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return m_target != other.m_target;
+        }
+    };
+
+private:
+    const NodeId* m_targets;
+    const W* m_weights;
+    std::size_t m_size;
+
+public:
+    BasicNeighborRange(const NodeId* targets, const W* weights,
+                       std::size_t size)
+        : m_targets(targets), m_weights(weights), m_size(size) {}
+
+    iterator begin() const { return {m_targets, m_weights}; }
+    iterator end() const { return {m_targets + m_size, m_weights + m_size}; }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const NodeId* targets() const { return m_targets; }
+    const W* weights() const { return m_weights; }
+};
+
+using NeighborRange = BasicNeighborRange<int>;
+
+#endif  // NEIGHBORS_H
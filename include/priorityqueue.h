@@ -0,0 +1,689 @@
+#ifndef PRIORITYQUEUE_H
+#define PRIORITYQUEUE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "neighbors.h"
+
+/*
+ * Colas de prioridad para la frontera de los solvers de búsqueda primero el
+ * mejor (UCS y A*). Cada cola es una plantilla sobre el tipo de la clave (el
+ * costo de los caminos) y se pasa al solver como parámetro de plantilla.
+ * Todas ofrecen la misma interfaz:
+ *
+ *   push(key, node)    agrega un nodo con la clave indicada
+ *   pop()              saca y devuelve la entrada de menor clave
+ *   empty(), size()
+ *   clear()            vacía la cola conservando la memoria reservada
+ *
+ * Salvo en los montículos indexados, un nodo puede estar varias veces en la
+ * cola; el solver descarta las entradas obsoletas al sacarlas. El orden entre
+ * entradas de igual clave no está definido.
+ */
+
+/**
+ * @brief Entrada de una cola de prioridad: un nodo y su clave.
+ */
+template <typename K>
+struct QueueEntry {
+    K key;
+    NodeId node;
+};
+
+/**
+ * @brief Montículo implícito de aridad `D` sobre un arreglo. Con `D` mayor que
+ * 2 el árbol es más bajo, así que `push` hace menos comparaciones y `pop`
+ * recorre menos niveles, a cambio de comparar más hijos en cada uno; los
+ * hijos de un nodo quedan contiguos en memoria.
+ */
+template <typename K, unsigned D>
+class DaryHeap {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+private:
+    std::vector<QueueEntry<K>> m_entries;
+
+public:
+    using key_type = K;
+
+    bool empty() const { return m_entries.empty(); }
+    std::size_t size() const { return m_entries.size(); }
+
+    void clear() { m_entries.clear(); }
+
+    void push(K key, NodeId node) {
+        // Subimos el hueco desde la última hoja hasta la posición del nuevo
+        // elemento, moviendo los padres hacia abajo.
+        auto hole = m_entries.size();
+        m_entries.emplace_back();
+
+        while (hole > 0) {
+            const auto parent = (hole - 1) / D;
+            if (!(key < m_entries[parent].key)) {
+                break;
+            }
+
+            m_entries[hole] = m_entries[parent];
+            hole = parent;
+        }
+
+        m_entries[hole] = {key, node};
+    }
+
+    QueueEntry<K> pop() {
+        const auto top = m_entries.front();
+        const auto last = m_entries.back();
+        m_entries.pop_back();
+
+        const auto size = m_entries.size();
+        if (size == 0) {
+            return top;
+        }
+
+        // Bajamos el hueco desde la raíz, subiendo en cada nivel el menor de
+        // los hijos, hasta encontrar el lugar del último elemento.
+        std::size_t hole = 0;
+        while (true) {
+            const auto first = hole * D + 1;
+            if (first >= size) {
+                break;
+            }
+
+            const auto end = first + D < size ? first + D : size;
+            auto best = first;
+            for (auto child = first + 1; child < end; ++child) {
+                if (m_entries[child].key < m_entries[best].key) {
+                    best = child;
+                }
+            }
+
+            if (!(m_entries[best].key < last.key)) {
+                break;
+            }
+
+            m_entries[hole] = m_entries[best];
+            hole = best;
+        }
+
+        m_entries[hole] = last;
+
+        return top;
+    }
+};
+
+template <typename K>
+using BinaryHeap = DaryHeap<K, 2>;
+
+template <typename K>
+using FourAryHeap = DaryHeap<K, 4>;
+
+template <typename K>
+using EightAryHeap = DaryHeap<K, 8>;
+
+/**
+ * @brief Montículo implícito de aridad `D` que guarda la posición de cada nodo,
+ * de modo que un nodo está a lo más una vez en la cola. Agregar un nodo que
+ * ya está equivale a `decrease_key`, así que la cola nunca tiene más entradas
+ * que nodos el grafo y no hay entradas obsoletas que sacar.
+ */
+template <typename K, unsigned D>
+class IndexedDaryHeap {
+    static_assert(D >= 2, "a heap needs at least two children per node");
+
+private:
+    static constexpr std::uint32_t absent =
+        std::numeric_limits<std::uint32_t>::max();
+
+    std::vector<QueueEntry<K>> m_entries;
+
+    // Posición de cada nodo en `m_entries`, o `absent` si no está en la
+    // cola. Crece a medida que llegan nodos con identificadores mayores.
+    std::vector<std::uint32_t> m_positions;
+
+    void place(std::size_t position, const QueueEntry<K>& entry) {
+        m_entries[position] = entry;
+        m_positions[entry.node] = static_cast<std::uint32_t>(position);
+    }
+
+    /**
+     * @brief Sube el hueco en `hole` hasta el lugar de `entry`.
+     */
+    void sift_up(std::size_t hole, const QueueEntry<K>& entry) {
+        while (hole > 0) {
+            const auto parent = (hole - 1) / D;
+            if (!(entry.key < m_entries[parent].key)) {
+                break;
+            }
+
+            place(hole, m_entries[parent]);
+            hole = parent;
+        }
+
+        place(hole, entry);
+    }
+
+    /**
+     * @brief Baja el hueco en `hole` hasta el lugar de `entry`.
+     */
+    void sift_down(std::size_t hole, const QueueEntry<K>& entry) {
+        const auto size = m_entries.size();
+        while (true) {
+            const auto first = hole * D + 1;
+            if (first >= size) {
+                break;
+            }
+
+            const auto end = first + D < size ? first + D : size;
+            auto best = first;
+            for (auto child = first + 1; child < end; ++child) {
+                if (m_entries[child].key < m_entries[best].key) {
+                    best = child;
+                }
+            }
+
+            if (!(m_entries[best].key < entry.key)) {
+                break;
+            }
+
+            place(hole, m_entries[best]);
+            hole = best;
+        }
+
+        place(hole, entry);
+    }
+
+public:
+    using key_type = K;
+
+    bool empty() const { return m_entries.empty(); }
+    std::size_t size() const { return m_entries.size(); }
+
+    bool contains(NodeId node) const {
+        return node < m_positions.size() && m_positions[node] != absent;
+    }
+
+    /**
+     * @brief Vacía la cola. Solo se recorren las entradas que quedaban, no
+     * el índice de posiciones completo.
+     */
+    void clear() {
+        for (const auto& entry : m_entries) {
+            m_positions[entry.node] = absent;
+        }
+
+        m_entries.clear();
+    }
+
+    /**
+     * @brief Agrega un nodo, o baja su clave si ya está en la cola. Si ya
+     * está con una clave menor o igual, no hace nada.
+     */
+    void push(K key, NodeId node) {
+        if (node >= m_positions.size()) {
+            const auto size = node + std::size_t{1};
+            m_positions.resize(
+                size > 2 * m_positions.size() ? size : 2 * m_positions.size(),
+                absent);
+        }
+
+        const auto position = m_positions[node];
+        if (position == absent) {
+            m_entries.emplace_back();
+            sift_up(m_entries.size() - 1, {key, node});
+        } else if (key < m_entries[position].key) {
+            sift_up(position, {key, node});
+        }
+    }
+
+    /**
+     * @brief Baja la clave de un nodo que está en la cola, en O(log_D n).
+     * @param key Nueva clave, que no debe ser mayor que la actual.
+     */
+    void decrease_key(K key, NodeId node) {
+        sift_up(m_positions[node], {key, node});
+    }
+
+    QueueEntry<K> pop() {
+        const auto top = m_entries.front();
+        const auto last = m_entries.back();
+        m_entries.pop_back();
+        m_positions[top.node] = absent;
+
+        if (!m_entries.empty()) {
+            sift_down(0, last);
+        }
+
+        return top;
+    }
+};
+
+template <typename K>
+using IndexedHeap = IndexedDaryHeap<K, 4>;
+
+/**
+ * @brief Montículo de emparejamiento (pairing heap). Insertar es O(1); sacar
+ * el mínimo reordena los hijos de la raíz en dos pasadas. Los nodos del árbol
+ * viven en un arreglo y se enlazan por índice, y las posiciones libres se
+ * reutilizan.
+ */
+template <typename K>
+class PairingHeap {
+private:
+    static constexpr std::uint32_t none =
+        std::numeric_limits<std::uint32_t>::max();
+
+    struct Node {
+        QueueEntry<K> entry;
+        std::uint32_t child;
+        std::uint32_t sibling;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<std::uint32_t> m_free;
+    std::vector<std::uint32_t> m_pairs;
+    std::uint32_t m_root = none;
+    std::size_t m_size = 0;
+
+    /**
+     * @brief Une dos árboles: el de mayor clave pasa a ser el primer hijo del
+     * otro.
+     */
+    std::uint32_t meld(std::uint32_t a, std::uint32_t b) {
+        if (a == none) {
+            return b;
+        }
+        if (b == none) {
+            return a;
+        }
+
+        if (m_nodes[b].entry.key < m_nodes[a].entry.key) {
+            std::swap(a, b);
+        }
+
+        m_nodes[b].sibling = m_nodes[a].child;
+        m_nodes[a].child = b;
+
+        return a;
+    }
+
+public:
+    using key_type = K;
+
+    bool empty() const { return m_size == 0; }
+    std::size_t size() const { return m_size; }
+
+    void clear() {
+        m_nodes.clear();
+        m_free.clear();
+        m_root = none;
+        m_size = 0;
+    }
+
+    void push(K key, NodeId node) {
+        std::uint32_t index;
+        if (!m_free.empty()) {
+            index = m_free.back();
+            m_free.pop_back();
+            m_nodes[index] = {{key, node}, none, none};
+        } else {
+            index = static_cast<std::uint32_t>(m_nodes.size());
+            m_nodes.push_back({{key, node}, none, none});
+        }
+
+        m_root = meld(m_root, index);
+        ++m_size;
+    }
+
+    QueueEntry<K> pop() {
+        const auto root = m_root;
+        const auto top = m_nodes[root].entry;
+
+        // Primera pasada: unir los hijos de a pares, de izquierda a derecha.
+        m_pairs.clear();
+        auto child = m_nodes[root].child;
+        while (child != none) {
+            const auto second = m_nodes[child].sibling;
+            const auto next = second != none ? m_nodes[second].sibling : none;
+
+            m_nodes[child].sibling = none;
+            if (second != none) {
+                m_nodes[second].sibling = none;
+            }
+
+            m_pairs.push_back(meld(child, second));
+            child = next;
+        }
+
+        // Segunda pasada: unir los pares de derecha a izquierda.
+        m_root = none;
+        for (auto it = m_pairs.rbegin(); it != m_pairs.rend(); ++it) {
+            m_root = meld(*it, m_root);
+        }
+
+        m_free.push_back(root);
+        --m_size;
+
+        return top;
+    }
+};
+
+namespace detail {
+
+/**
+ * @brief Número de bits necesarios para representar `value` (0 para 0).
+ */
+inline unsigned bit_width(std::uint64_t value) {
+#if defined(__GNUC__)
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+#else
+    unsigned width = 0;
+    while (value != 0) {
+        value >>= 1;
+        ++width;
+    }
+    return width;
+#endif
+}
+
+/**
+ * @brief Convierte una clave en un entero sin signo de 64 bits con el mismo
+ * orden, para repartirla en los baldes de un montículo radix.
+ */
+template <typename K>
+std::uint64_t radix_key(K key) {
+    if constexpr (std::is_floating_point_v<K>) {
+        // En IEEE 754 los números positivos se ordenan como sus bits; los
+        // negativos, al revés. Se invierten los negativos y se marca el bit
+        // de signo de los positivos.
+        const double value = key;
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+        return (bits >> 63) != 0 ? ~bits : bits | (std::uint64_t{1} << 63);
+    } else if constexpr (std::is_signed_v<K>) {
+        return static_cast<std::uint64_t>(key) ^ (std::uint64_t{1} << 63);
+    } else {
+        return key;
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Montículo radix. Aprovecha que en Dijkstra (y en A* con una
+ * heurística consistente) las claves que se agregan nunca son menores que la
+ * última que se sacó: cada entrada se guarda en el balde del bit más alto en
+ * que su clave difiere de esa última, y solo se reparte de nuevo cuando su
+ * balde pasa a ser el primero. Cada entrada se mueve a lo más 64 veces.
+ *
+ * Si llega una clave menor que la última que se sacó (por ejemplo, en A* con
+ * una heurística inconsistente, o con pesos negativos), la cola pasa todas sus
+ * entradas a un montículo binario y sigue como tal hasta el final.
+ */
+template <typename K>
+class RadixHeap {
+private:
+    std::array<std::vector<QueueEntry<K>>, 65> m_buckets;
+    std::vector<QueueEntry<K>> m_scratch;
+    std::uint64_t m_last = 0;
+    std::size_t m_size = 0;
+
+    bool m_fallen_back = false;
+    BinaryHeap<K> m_fallback;
+
+    std::size_t bucket(std::uint64_t key) const {
+        return detail::bit_width(key ^ m_last);
+    }
+
+    void fall_back() {
+        for (auto& bucket : m_buckets) {
+            for (const auto& entry : bucket) {
+                m_fallback.push(entry.key, entry.node);
+            }
+            bucket.clear();
+        }
+
+        m_size = 0;
+        m_fallen_back = true;
+    }
+
+public:
+    using key_type = K;
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t size() const {
+        return m_fallen_back ? m_fallback.size() : m_size;
+    }
+
+    /**
+     * @brief Indica si la cola dejó de ser un montículo radix porque las
+     * claves no fueron monótonas.
+     */
+    bool fallen_back() const { return m_fallen_back; }
+
+    void clear() {
+        for (auto& bucket : m_buckets) {
+            bucket.clear();
+        }
+
+        m_last = 0;
+        m_size = 0;
+        m_fallen_back = false;
+        m_fallback.clear();
+    }
+
+    void push(K key, NodeId node) {
+        if (!m_fallen_back) {
+            const auto radix = detail::radix_key(key);
+            if (radix >= m_last) {
+                m_buckets[bucket(radix)].push_back({key, node});
+                ++m_size;
+                return;
+            }
+
+            fall_back();
+        }
+
+        m_fallback.push(key, node);
+    }
+
+    QueueEntry<K> pop() {
+        if (m_fallen_back) {
+            return m_fallback.pop();
+        }
+
+        if (m_buckets[0].empty()) {
+            // Tomamos el primer balde con entradas, su menor clave pasa a ser
+            // la última, y repartimos el balde con respecto a ella. Todas sus
+            // entradas quedan en baldes anteriores.
+            std::size_t i = 1;
+            while (m_buckets[i].empty()) {
+                ++i;
+            }
+
+            // El balde se intercambia con uno auxiliar para conservar la
+            // memoria reservada de ambos.
+            m_scratch.swap(m_buckets[i]);
+
+            m_last = detail::radix_key(m_scratch.front().key);
+            for (const auto& entry : m_scratch) {
+                const auto radix = detail::radix_key(entry.key);
+                if (radix < m_last) {
+                    m_last = radix;
+                }
+            }
+
+            for (const auto& entry : m_scratch) {
+                m_buckets[bucket(detail::radix_key(entry.key))].push_back(
+                    entry);
+            }
+
+            m_scratch.clear();
+        }
+
+        const auto top = m_buckets[0].back();
+        m_buckets[0].pop_back();
+        --m_size;
+
+        return top;
+    }
+};
+
+/**
+ * @brief Cola de baldes de Dial, para claves enteras. Hay un balde por cada
+ * clave entre la última que se sacó y la mayor de la cola, en un arreglo
+ * circular que crece (a la siguiente potencia de 2) cuando llega una clave
+ * fuera de su rango. Conviene cuando los pesos son enteros pequeños, porque
+ * entonces el arreglo es corto y sacar el mínimo es recorrer unos pocos
+ * baldes.
+ *
+ * Igual que el montículo radix, si llega una clave menor que la última que se
+ * sacó, la cola pasa a ser un montículo binario. Lo mismo ocurre si el rango
+ * de claves necesitaría más de `max_buckets` baldes: cada balde vacío ocupa
+ * la cabecera de un std::vector, así que el arreglo se limita a unos pocos
+ * MB y un solo peso muy grande no lo hace crecer sin control.
+ */
+template <typename K>
+class DialQueue {
+    static_assert(std::is_integral_v<K>, "Dial's queue needs integer keys");
+
+private:
+    static constexpr std::uint64_t max_buckets = std::uint64_t{1} << 16;
+
+    std::vector<std::vector<NodeId>> m_buckets =
+        std::vector<std::vector<NodeId>>(64);
+    K m_cursor = 0;
+    std::size_t m_size = 0;
+    bool m_started = false;
+
+    bool m_fallen_back = false;
+    BinaryHeap<K> m_fallback;
+
+    std::size_t slot(K key) const {
+        return static_cast<std::size_t>(key) & (m_buckets.size() - 1);
+    }
+
+    /**
+     * @brief Agranda el arreglo circular para que quepan claves hasta
+     * `span` por sobre el cursor.
+     */
+    void grow(std::uint64_t span) {
+        auto size = m_buckets.size();
+        while (size <= span) {
+            size *= 2;
+        }
+
+        std::vector<std::vector<NodeId>> buckets(size);
+        const auto old_mask = m_buckets.size() - 1;
+        for (std::size_t i = 0; i < m_buckets.size(); ++i) {
+            // La clave de un balde es la primera desde el cursor que cae en
+            // él.
+            const auto offset = (i - static_cast<std::size_t>(m_cursor)) &
+                                old_mask;
+            const auto key = m_cursor + static_cast<K>(offset);
+            buckets[static_cast<std::size_t>(key) & (size - 1)] =
+                std::move(m_buckets[i]);
+        }
+
+        m_buckets = std::move(buckets);
+    }
+
+    void fall_back() {
+        const auto mask = m_buckets.size() - 1;
+        for (std::size_t i = 0; i < m_buckets.size(); ++i) {
+            const auto offset = (i - static_cast<std::size_t>(m_cursor)) & mask;
+            const auto key = m_cursor + static_cast<K>(offset);
+            for (const auto node : m_buckets[i]) {
+                m_fallback.push(key, node);
+            }
+            m_buckets[i].clear();
+        }
+
+        m_size = 0;
+        m_fallen_back = true;
+    }
+
+public:
+    using key_type = K;
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t size() const {
+        return m_fallen_back ? m_fallback.size() : m_size;
+    }
+
+    /**
+     * @brief Indica si la cola dejó de usar baldes porque las claves no
+     * fueron monótonas.
+     */
+    bool fallen_back() const { return m_fallen_back; }
+
+    void clear() {
+        if (m_size != 0) {
+            for (auto& bucket : m_buckets) {
+                bucket.clear();
+            }
+        }
+
+        m_cursor = 0;
+        m_size = 0;
+        m_started = false;
+        m_fallen_back = false;
+        m_fallback.clear();
+    }
+
+    void push(K key, NodeId node) {
+        if (m_fallen_back) {
+            m_fallback.push(key, node);
+            return;
+        }
+
+        // El cursor parte en la primera clave.
+        if (!m_started) {
+            m_cursor = key;
+            m_started = true;
+        }
+
+        const auto span = static_cast<std::uint64_t>(key) -
+                          static_cast<std::uint64_t>(m_cursor);
+        if (key < m_cursor || span >= max_buckets) {
+            fall_back();
+            m_fallback.push(key, node);
+            return;
+        }
+
+        if (span >= m_buckets.size()) {
+            grow(span);
+        }
+
+        m_buckets[slot(key)].push_back(node);
+        ++m_size;
+    }
+
+    QueueEntry<K> pop() {
+        if (m_fallen_back) {
+            return m_fallback.pop();
+        }
+
+        while (m_buckets[slot(m_cursor)].empty()) {
+            ++m_cursor;
+        }
+
+        auto& bucket = m_buckets[slot(m_cursor)];
+        const auto node = bucket.back();
+        bucket.pop_back();
+        --m_size;
+
+        return {m_cursor, node};
+    }
+};
+
+#endif  // PRIORITYQUEUE_H
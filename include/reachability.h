@@ -0,0 +1,104 @@
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arrayview.h"
+#include "graph.h"
+
+template <typename W>
+class BasicCsrGraph;
+
+/**
+ * @brief Estado de las consultas a un ReachabilityIndex que recorren el DAG
+ * de condensación, para reutilizarlo entre consultas: las componentes
+ * visitadas y la pila del recorrido.
+ *
+ * Igual que en SearchWorkspace, una componente está visitada si su marca es
+ * igual a la generación actual, así que empezar una consulta es O(1). Cada
+ * hilo que consulte un índice compartido usa su propio espacio de trabajo.
+ */
+class ReachabilityWorkspace {
+private:
+    std::vector<std::uint32_t> m_seen;
+    std::uint32_t m_generation = 0;
+    std::vector<NodeId> m_pending;
+
+    friend class ReachabilityIndex;
+
+    void reset(std::size_t component_count);
+};
+
+/**
+ * @brief Índice de alcanzabilidad de un grafo, construido a partir de sus
+ * componentes fuertemente conexas y del DAG que se obtiene al contraer cada
+ * una en un solo nodo (la condensación). Permite descartar antes de buscar
+ * los pares de nodos sin camino entre ellos.
+ *
+ * Igual que en CsrGraph, los arreglos están en un almacenamiento compartido
+ * (vectores propios o el snapshot mapeado en memoria del que se leyó el
+ * índice), así que copiar el índice no los copia. El índice no cambia al
+ * consultarlo, así que se puede compartir entre hilos; el estado de cada
+ * consulta vive en un ReachabilityWorkspace.
+ */
+class ReachabilityIndex {
+private:
+    /**
+     * @brief Arreglos de un índice construido en memoria.
+     */
+    struct Arrays {
+        std::vector<NodeId> component;
+        std::vector<NodeId> weak;
+        std::vector<NodeId> level;
+        std::vector<std::uint64_t> dag_offsets;
+        std::vector<NodeId> dag_targets;
+    };
+
+    std::shared_ptr<const void> m_storage;
+
+    // Componente fuertemente conexa de cada nodo.
+    ArrayView<NodeId> m_component;
+
+    // Por componente: su componente débilmente conexa y su nivel en el DAG
+    // (el largo del camino más largo que llega a ella).
+    ArrayView<NodeId> m_weak;
+    ArrayView<NodeId> m_level;
+
+    // Aristas del DAG de condensación, sin repetir, en formato CSR.
+    ArrayView<std::uint64_t> m_dag_offsets;
+    ArrayView<NodeId> m_dag_targets;
+
+    ReachabilityIndex() = default;
+
+    template <typename G>
+    static void find_components(const G& graph, Arrays& arrays);
+    template <typename G>
+    static void build_condensation(const G& graph, Arrays& arrays);
+
+    template <typename U>
+    friend BasicCsrGraph<U> read_snapshot(const std::string& path,
+                                          bool verify);
+
+public:
+    template <typename G>
+    explicit ReachabilityIndex(const G& graph);
+
+    std::size_t component_count() const;
+    NodeId component(NodeId node) const;
+
+    bool reachable(NodeId from, NodeId to) const;
+    bool reachable(NodeId from, NodeId to,
+                   ReachabilityWorkspace& workspace) const;
+
+    ArrayView<NodeId> components() const;
+    ArrayView<NodeId> weak_components() const;
+    ArrayView<NodeId> levels() const;
+    ArrayView<std::uint64_t> dag_offsets() const;
+    ArrayView<NodeId> dag_targets() const;
+};
+
+#endif  // REACHABILITY_H
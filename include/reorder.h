@@ -0,0 +1,17 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <vector>
+
+#include "csrgraph.h"
+
+template <typename W>
+std::vector<NodeId> bfs_order(const BasicCsrGraph<W>& graph);
+template <typename W>
+std::vector<NodeId> rcm_order(const BasicCsrGraph<W>& graph);
+
+template <typename W>
+BasicCsrGraph<W> reorder(const BasicCsrGraph<W>& graph,
+                         const std::vector<NodeId>& order);
+
+#endif  // REORDER_H
@@ -0,0 +1,38 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "csrgraph.h"
+
+/**
+ * @brief Archivo de texto a partir del cual se generó un snapshot, cuando el
+ * snapshot es la caché de ese archivo. Un snapshot que no es caché tiene
+ * todos los campos en 0.
+ */
+struct SnapshotSource {
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0;
+    std::uint64_t hash = 0;
+};
+
+/**
+ * @brief Datos de la cabecera de un snapshot que se pueden consultar sin
+ * abrir el grafo.
+ */
+struct SnapshotInfo {
+    GraphMode mode;
+    SnapshotSource source;
+};
+
+template <typename W>
+void write_snapshot(const BasicCsrGraph<W>& graph, const std::string& path,
+                    const SnapshotSource& source);
+template <typename W>
+BasicCsrGraph<W> read_snapshot(const std::string& path, bool verify);
+bool is_snapshot(const std::string& path);
+std::optional<SnapshotInfo> read_snapshot_info(const std::string& path);
+
+#endif  // SNAPSHOT_H
@@ -5,23 +5,37 @@
 #include <vector>
 
 #include "graph.h"
+#include "heuristics.h"
+#include "priorityqueue.h"
 #include "solvers/solver.h"
+#include "solvers/workspace.h"
+#include "weight.h"
+
+template <typename G, typename H = FileHeuristic<G>,
+          template <typename> class Q = IndexedHeap>
+class AStarSolver : public Solver<graph_cost_t<G>> {
+public:
+    using cost_type = graph_cost_t<G>;
+    using workspace_type = SearchWorkspace<cost_type, Q>;
 
-class AStarSolver : public Solver {
 private:
-    const Graph& m_graph;
+    const G& m_graph;
+    H m_heuristic;
+
+    std::vector<NodeId> m_path;
+    cost_type m_cost;
 
-    std::vector<std::string> m_path;
-    int m_cost;
-    std::map<std::string, int> m_visit_count;
+    // Número de expansiones de cada nodo de `m_path`.
+    std::vector<int> m_path_visits;
 
-    void solve();
+    void solve(workspace_type& workspace);
 
 public:
-    explicit AStarSolver(const Graph& graph);
+    AStarSolver(const G& graph, H heuristic);
+    AStarSolver(const G& graph, H heuristic, workspace_type& workspace);
 
     std::vector<std::string> solution() const;
-    int cost() const;
+    cost_type cost() const;
     std::map<std::string, int> visit_count() const;
 };
 
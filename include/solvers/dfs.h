@@ -3,34 +3,41 @@
 
 #include <map>
 #include <optional>
-#include <stack>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "graph.h"
+#include "heuristics.h"
 #include "solvers/solver.h"
+#include "weight.h"
+
+template <typename G, typename H = FileHeuristic<G>>
+class DFSSolver : public Solver<graph_cost_t<G>> {
+public:
+    using cost_type = graph_cost_t<G>;
 
-class DFSSolver : public Solver {
 private:
-    const Graph& m_graph;
+    const G& m_graph;
+    H m_heuristic;
 
-    std::vector<std::string> m_path;
-    int m_cost;
+    std::vector<NodeId> m_path;
+    cost_type m_cost;
 
-    std::set<std::string> m_visited;
-    std::stack<std::string> m_stack;
+    std::set<NodeId> m_visited;
+    std::map<NodeId, int> m_visits;
     std::map<std::string, int> m_visit_count;
 
     int random_pos(int max) const;
 
-    std::vector<std::string> dfs(const std::string& cur_node);
+    std::vector<NodeId> dfs(NodeId cur_node, cost_type cost);
     void solve();
 
 public:
-    explicit DFSSolver(const Graph& graph);
+    DFSSolver(const G& graph, H heuristic);
 
     std::vector<std::string> solution() const;
-    int cost() const;
+    cost_type cost() const;
     std::map<std::string, int> visit_count() const;
 };
 
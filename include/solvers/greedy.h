@@ -8,23 +8,30 @@
 #include <vector>
 
 #include "graph.h"
+#include "heuristics.h"
 #include "solvers/solver.h"
+#include "weight.h"
 
+template <typename G, typename H = FileHeuristic<G>>
 class GreedySolver {
+public:
+    using cost_type = graph_cost_t<G>;
+
 private:
-    const Graph& m_graph;
+    const G& m_graph;
+    H m_heuristic;
 
-    std::vector<std::string> m_path;
-    int m_cost;
+    std::vector<NodeId> m_path;
+    cost_type m_cost;
     std::map<std::string, int> m_visit_count;
 
     void solve();
 
 public:
-    explicit GreedySolver(const Graph& graph);
+    GreedySolver(const G& graph, H heuristic);
 
     std::vector<std::string> solution() const;
-    int cost() const;
+    cost_type cost() const;
     std::map<std::string, int> visit_count() const;
 };
 
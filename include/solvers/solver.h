@@ -5,11 +5,12 @@
 #include <string>
 #include <vector>
 
+template <typename C>
 class Solver {
 public:
     virtual ~Solver() = default;
     virtual std::vector<std::string> solution() const = 0;
-    virtual int cost() const = 0;
+    virtual C cost() const = 0;
     virtual std::map<std::string, int> visit_count() const = 0;
 };
 
@@ -8,23 +8,34 @@
 #include <vector>
 
 #include "graph.h"
+#include "priorityqueue.h"
 #include "solvers/solver.h"
+#include "solvers/workspace.h"
+#include "weight.h"
 
+template <typename G, template <typename> class Q = IndexedHeap>
 class UCSSolver {
+public:
+    using cost_type = graph_cost_t<G>;
+    using workspace_type = SearchWorkspace<cost_type, Q>;
+
 private:
-    const Graph& m_graph;
+    const G& m_graph;
+
+    std::vector<NodeId> m_path;
+    cost_type m_cost;
 
-    std::vector<std::string> m_path;
-    int m_cost;
-    std::map<std::string, int> m_visit_count;
+    // Número de expansiones de cada nodo de `m_path`.
+    std::vector<int> m_path_visits;
 
-    void solve();
+    void solve(workspace_type& workspace);
 
 public:
-    explicit UCSSolver(const Graph& graph);
+    explicit UCSSolver(const G& graph);
+    UCSSolver(const G& graph, workspace_type& workspace);
 
     std::vector<std::string> solution() const;
-    int cost() const;
+    cost_type cost() const;
     std::map<std::string, int> visit_count() const;
 };
 
@@ -0,0 +1,111 @@
+#ifndef SOLVERS_WORKSPACE_H
+#define SOLVERS_WORKSPACE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graph.h"
+#include "priorityqueue.h"
+
+/**
+ * @brief Estado de una búsqueda primero el mejor (UCS y A*) que se reutiliza
+ * entre consultas: el costo, el padre y el número de expansiones de cada
+ * nodo, y la frontera, con la cola `Q`.
+ *
+ * Los arreglos por nodo no se limpian entre consultas. Cada nodo guarda la
+ * generación (el número de consulta) en que se alcanzó por última vez, y
+ * `reset` solo incrementa la generación actual, así que los datos de las
+ * consultas anteriores quedan invalidados en O(1) y cada consulta paga solo
+ * por los nodos que toca. El contador de expansiones de un nodo se pone en 0
+ * la primera vez que se alcanza en la consulta.
+ */
+template <typename C, template <typename> class Q>
+class SearchWorkspace {
+public:
+    using cost_type = C;
+    using queue_type = Q<C>;
+
+private:
+    std::vector<cost_type> m_costs;
+    std::vector<NodeId> m_parents;
+    std::vector<std::uint32_t> m_expansions;
+    std::vector<std::uint32_t> m_generations;
+    std::uint32_t m_generation = 0;
+
+    queue_type m_frontier;
+
+public:
+    /**
+     * @brief Prepara el espacio para una nueva consulta sobre un grafo de
+     * `node_count` nodos. Los arreglos solo crecen; si el grafo es más
+     * pequeño que el anterior, se usa una parte de ellos.
+     */
+    void reset(std::size_t node_count) {
+        if (m_generations.size() < node_count) {
+            m_costs.resize(node_count);
+            m_parents.resize(node_count);
+            m_expansions.resize(node_count);
+            m_generations.resize(node_count, 0);
+        }
+
+        // Al dar la vuelta el contador, una marca vieja podría coincidir con
+        // la nueva generación, así que las marcas se borran una vez.
+        if (++m_generation == 0) {
+            std::fill(std::begin(m_generations), std::end(m_generations), 0);
+            m_generation = 1;
+        }
+
+        m_frontier.clear();
+    }
+
+    /**
+     * @brief Indica si el nodo se alcanzó en la consulta actual.
+     */
+    bool reached(NodeId node) const {
+        return m_generations[node] == m_generation;
+    }
+
+    /**
+     * @brief Registra que se llegó a un nodo con el costo y el padre
+     * indicados.
+     */
+    void reach(NodeId node, cost_type cost, NodeId parent) {
+        if (m_generations[node] != m_generation) {
+            m_generations[node] = m_generation;
+            m_expansions[node] = 0;
+        }
+
+        m_costs[node] = cost;
+        m_parents[node] = parent;
+    }
+
+    /**
+     * @brief Costo con que se alcanzó un nodo. Solo es válido si
+     * `reached(node)`.
+     */
+    cost_type cost(NodeId node) const { return m_costs[node]; }
+
+    /**
+     * @brief Padre de un nodo en el camino encontrado. Solo es válido si
+     * `reached(node)`.
+     */
+    NodeId parent(NodeId node) const { return m_parents[node]; }
+
+    /**
+     * @brief Registra que se expandió un nodo ya alcanzado.
+     */
+    void expand(NodeId node) { m_expansions[node]++; }
+
+    /**
+     * @brief Número de veces que se expandió un nodo en la consulta actual.
+     */
+    std::uint32_t expansions(NodeId node) const {
+        return reached(node) ? m_expansions[node] : 0;
+    }
+
+    queue_type& frontier() { return m_frontier; }
+};
+
+#endif  // SOLVERS_WORKSPACE_H
@@ -0,0 +1,84 @@
+#ifndef WEIGHT_H
+#define WEIGHT_H
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * @brief Propiedades del tipo de peso de las aristas. Los pesos se guardan
+ * con el tipo `W`, que puede ser angosto para ahorrar memoria, mientras que
+ * los costos de los caminos se acumulan en `cost_type`, que es de 64 bits.
+ *
+ * Para pesos enteros la suma se satura en los extremos de `cost_type`, de
+ * modo que una ruta muy larga queda con costo infinito en vez de dar la
+ * vuelta. Para pesos de punto flotante la suma es la usual.
+ */
+template <typename W, typename = void>
+struct WeightTraits;
+
+template <typename W>
+struct WeightTraits<W, std::enable_if_t<std::is_integral_v<W>>> {
+    using weight_type = W;
+    using cost_type = std::conditional_t<std::is_signed_v<W>, std::int64_t,
+                                         std::uint64_t>;
+
+    static constexpr cost_type infinity() {
+        return std::numeric_limits<cost_type>::max();
+    }
+
+    static constexpr cost_type add(cost_type lhs, cost_type rhs) {
+        constexpr auto max = std::numeric_limits<cost_type>::max();
+        constexpr auto min = std::numeric_limits<cost_type>::min();
+
+        if (rhs > 0 && lhs > max - rhs) {
+            return max;
+        }
+
+        if constexpr (std::is_signed_v<cost_type>) {
+            if (rhs < 0 && lhs < min - rhs) {
+                return min;
+            }
+        }
+
+        return lhs + rhs;
+    }
+
+    /**
+     * @brief Revisa si un peso leído como int se puede guardar sin perder
+     * información.
+     */
+    static constexpr bool fits(int value) {
+        if constexpr (std::is_signed_v<W>) {
+            return value >= std::numeric_limits<W>::min() &&
+                   value <= std::numeric_limits<W>::max();
+        } else {
+            return value >= 0 && static_cast<std::uintmax_t>(value) <=
+                                     std::numeric_limits<W>::max();
+        }
+    }
+};
+
+template <typename W>
+struct WeightTraits<W, std::enable_if_t<std::is_floating_point_v<W>>> {
+    using weight_type = W;
+    using cost_type = double;
+
+    static constexpr cost_type infinity() {
+        return std::numeric_limits<cost_type>::infinity();
+    }
+
+    static constexpr cost_type add(cost_type lhs, cost_type rhs) {
+        return lhs + rhs;
+    }
+
+    static constexpr bool fits(int) { return true; }
+};
+
+/**
+ * @brief Tipo en que se acumulan los costos de los caminos de un grafo `G`.
+ */
+template <typename G>
+using graph_cost_t = typename WeightTraits<typename G::weight_type>::cost_type;
+
+#endif  // WEIGHT_H
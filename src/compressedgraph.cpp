@@ -0,0 +1,527 @@
+#include "compressedgraph.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Agrega un entero sin signo en formato varint (LEB128): 7 bits por
+ * byte, con el bit alto indicando que siguen más bytes.
+ */
+void put_varint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * @brief Lee un entero en formato varint y avanza el cursor.
+ */
+std::uint64_t get_varint(const std::uint8_t*& bytes) {
+    std::uint64_t value = 0;
+    unsigned shift = 0;
+
+    while (*bytes & 0x80) {
+        value |= static_cast<std::uint64_t>(*bytes++ & 0x7f) << shift;
+        shift += 7;
+    }
+
+    return value | (static_cast<std::uint64_t>(*bytes++) << shift);
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^
+           static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^
+           -static_cast<std::int64_t>(value & 1);
+}
+
+/**
+ * @brief Orden alfabético de los nodos. Un CsrGraph ya lo tiene calculado.
+ */
+std::vector<NodeId> make_name_order(const CsrGraph& graph) {
+    return {std::cbegin(graph.name_order()), std::cend(graph.name_order())};
+}
+
+std::vector<NodeId> make_name_order(const Graph& graph) {
+    std::vector<NodeId> order(graph.vertex_count());
+    std::iota(std::begin(order), std::end(order), 0);
+    std::sort(std::begin(order), std::end(order),
+              [&graph](NodeId lhs, NodeId rhs) {
+                  return graph.node_name(lhs) < graph.node_name(rhs);
+              });
+
+    return order;
+}
+
+/**
+ * @brief Índice de alcanzabilidad ya construido del grafo de origen, si lo
+ * tiene. Copiar el índice no copia sus arreglos.
+ */
+std::shared_ptr<const ReachabilityIndex> shared_reachability(
+    const CsrGraph& graph) {
+    if (!graph.has_reachability()) {
+        return nullptr;
+    }
+
+    return std::make_shared<const ReachabilityIndex>(graph.reachability());
+}
+
+std::shared_ptr<const ReachabilityIndex> shared_reachability(const Graph&) {
+    return nullptr;
+}
+
+}  // namespace
+
+/**
+ * @brief Constructor. Se posiciona en la primera arista de una fila.
+ * @param graph Grafo al que pertenece la fila.
+ * @param from Nodo de origen de la fila.
+ * @param bytes Inicio de los destinos codificados de la fila.
+ * @param edge Índice global de la primera arista de la fila.
+ * @param remaining Cantidad de aristas de la fila.
+ */
+CompressedGraph::NeighborRange::iterator::iterator(const CompressedGraph* graph,
+                                                   NodeId from,
+                                                   const std::uint8_t* bytes,
+                                                   std::uint64_t edge,
+                                                   std::uint64_t remaining)
+    : m_graph(graph),
+      m_bytes(bytes),
+      m_edge(edge),
+      m_remaining(remaining),
+      m_target(from),
+      m_first(true) {
+    decode();
+}
+
+/**
+ * @brief Decodifica el destino de la arista actual, si queda alguna.
+ */
+void CompressedGraph::NeighborRange::iterator::decode() {
+    if (m_remaining == 0) {
+        return;
+    }
+
+    const auto delta = get_varint(m_bytes);
+    if (m_first) {
+        m_target = static_cast<NodeId>(static_cast<std::int64_t>(m_target) +
+                                       unzigzag(delta));
+        m_first = false;
+    } else {
+        m_target += static_cast<NodeId>(delta);
+    }
+}
+
+CompressedGraph::NeighborRange::iterator
+CompressedGraph::NeighborRange::begin() const {
+    return {m_graph, m_from,
+            m_graph->m_targets.data() + m_graph->byte_offset(m_from),
+            m_graph->edge_offset(m_from), size()};
+}
+
+CompressedGraph::NeighborRange::iterator CompressedGraph::NeighborRange::end()
+    const {
+    return {m_graph, m_from, nullptr, m_graph->edge_offset(m_from + 1), 0};
+}
+
+std::size_t CompressedGraph::NeighborRange::size() const {
+    return m_graph->edge_offset(m_from + 1) - m_graph->edge_offset(m_from);
+}
+
+/**
+ * @brief Obtiene el índice global de la primera arista de una fila.
+ * @param node Nodo de la fila, o `vertex_count()` para el final.
+ */
+std::uint64_t CompressedGraph::edge_offset(NodeId node) const {
+    return m_blocks[node / block_size].edge + m_rows[node].edge;
+}
+
+/**
+ * @brief Obtiene la posición del primer byte de una fila en `m_targets`.
+ * @param node Nodo de la fila, o `vertex_count()` para el final.
+ */
+std::uint64_t CompressedGraph::byte_offset(NodeId node) const {
+    return m_blocks[node / block_size].byte + m_rows[node].byte;
+}
+
+/**
+ * @brief Registra el inicio de la siguiente fila. La primera fila de cada
+ * bloque abre un bloque nuevo.
+ * @param edge Índice global de la primera arista de la fila.
+ * @param byte Posición del primer byte de la fila.
+ * @throws std::length_error si un bloque de filas no cabe en 32 bits.
+ */
+void CompressedGraph::add_row_offset(std::uint64_t edge, std::uint64_t byte) {
+    if (m_rows.size() % block_size == 0) {
+        m_blocks.push_back({edge, byte});
+    }
+
+    const auto& block = m_blocks.back();
+    if (edge - block.edge > std::numeric_limits<std::uint32_t>::max() ||
+        byte - block.byte > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("Block of rows is too large to compress");
+    }
+
+    m_rows.push_back({static_cast<std::uint32_t>(edge - block.edge),
+                      static_cast<std::uint32_t>(byte - block.byte)});
+}
+
+/**
+ * @brief Obtiene el peso de una arista desde el arreglo de bits.
+ * @param edge Índice global de la arista.
+ * @return Peso de la arista.
+ */
+CompressedGraph::weight_type CompressedGraph::weight_at(
+    std::uint64_t edge) const {
+    if (m_weight_bits == 0) {
+        return m_min_weight;
+    }
+
+    const auto bit = edge * m_weight_bits;
+    const auto word = bit / 64;
+    const auto shift = bit % 64;
+
+    // El arreglo tiene una palabra extra al final, así que leer la siguiente
+    // palabra nunca se sale de él.
+    std::uint64_t value = m_weights[word] >> shift;
+    if (shift + m_weight_bits > 64) {
+        value |= m_weights[word + 1] << (64 - shift);
+    }
+    value &= (std::uint64_t{1} << m_weight_bits) - 1;
+
+    return static_cast<weight_type>(static_cast<std::int64_t>(m_min_weight) +
+                                    static_cast<std::int64_t>(value));
+}
+
+/**
+ * @brief Revisa si un identificador corresponde a un nodo del grafo.
+ * @param node Identificador del nodo.
+ * @return true si el nodo está en el grafo, false en caso contrario.
+ */
+bool CompressedGraph::check_node(NodeId node) const {
+    return node < m_heuristics.size();
+}
+
+/**
+ * @brief Constructor. Comprime un grafo fila por fila, sin copiarlo antes a
+ * otra representación. Los identificadores de los nodos se conservan. Las
+ * filas se ordenan por destino al codificarlas; el orden es estable, como en
+ * CsrGraph.
+ * @param graph Grafo a comprimir: un Graph o un CsrGraph.
+ * @throws std::length_error si un bloque de filas no cabe en 32 bits.
+ */
+template <typename G>
+CompressedGraph::CompressedGraph(const G& graph)
+    : m_blocks(),
+      m_rows(),
+      m_targets(),
+      m_weights(),
+      m_weight_bits(0),
+      m_min_weight(0),
+      m_heuristics(),
+      m_name_offsets(),
+      m_names(),
+      m_name_order(make_name_order(graph)),
+      m_start(Graph::invalid_node),
+      m_end(Graph::invalid_node),
+      m_reachability(shared_reachability(graph)) {
+    const auto node_count = static_cast<NodeId>(graph.vertex_count());
+
+    // Primera pasada: el rango de los pesos fija el ancho de bits con que se
+    // empaquetan, como desplazamientos desde el menor.
+    std::uint64_t total = 0;
+    weight_type max_weight = 0;
+    for (NodeId node = 0; node < node_count; ++node) {
+        for (const auto [_, weight] : graph.neighbors(node)) {
+            if (total++ == 0) {
+                m_min_weight = max_weight = weight;
+            }
+
+            m_min_weight = std::min(m_min_weight, weight);
+            max_weight = std::max(max_weight, weight);
+        }
+    }
+
+    const auto range = static_cast<std::uint64_t>(
+        static_cast<std::int64_t>(max_weight) - m_min_weight);
+    while (m_weight_bits < 64 && (range >> m_weight_bits) != 0) {
+        ++m_weight_bits;
+    }
+
+    m_weights.assign((total * m_weight_bits + 63) / 64 + 1, 0);
+
+    // Segunda pasada: cada fila se ordena en un arreglo auxiliar y se
+    // codifica. Como quedan ordenadas, las diferencias entre destinos
+    // consecutivos no son negativas.
+    m_blocks.reserve(node_count / block_size + 1);
+    m_rows.reserve(node_count + std::size_t{1});
+    m_heuristics.reserve(node_count);
+    m_name_offsets.reserve(node_count + std::size_t{1});
+    m_name_offsets.push_back(0);
+
+    std::vector<std::pair<NodeId, weight_type>> row;
+    std::uint64_t edge = 0;
+    for (NodeId node = 0; node < node_count; ++node) {
+        add_row_offset(edge, m_targets.size());
+
+        const auto neighbors = graph.neighbors(node);
+        row.assign(std::begin(neighbors), std::end(neighbors));
+        const auto by_target = [](const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        };
+        if (!std::is_sorted(std::cbegin(row), std::cend(row), by_target)) {
+            std::stable_sort(std::begin(row), std::end(row), by_target);
+        }
+
+        auto prev = static_cast<std::int64_t>(node);
+        bool first = true;
+        for (const auto& [to, weight] : row) {
+            const auto target = static_cast<std::int64_t>(to);
+            put_varint(m_targets, first ? zigzag(target - prev)
+                                        : static_cast<std::uint64_t>(
+                                              target - prev));
+            prev = target;
+            first = false;
+
+            if (m_weight_bits > 0) {
+                const auto value = static_cast<std::uint64_t>(
+                    static_cast<std::int64_t>(weight) - m_min_weight);
+                const auto bit = edge * m_weight_bits;
+                const auto word = bit / 64;
+                const auto shift = bit % 64;
+
+                m_weights[word] |= value << shift;
+                if (shift + m_weight_bits > 64) {
+                    m_weights[word + 1] |= value >> (64 - shift);
+                }
+            }
+
+            ++edge;
+        }
+
+        const std::string_view name = graph.node_name(node);
+        m_names.insert(std::end(m_names), std::cbegin(name), std::cend(name));
+        m_name_offsets.push_back(m_names.size());
+        m_heuristics.push_back(graph.get_heuristic(node));
+    }
+
+    add_row_offset(edge, m_targets.size());
+    m_targets.shrink_to_fit();
+    m_names.shrink_to_fit();
+
+    try {
+        m_start = graph.start_id();
+        m_end = graph.end_id();
+    } catch (const std::runtime_error&) {
+        // Un grafo sin origen o destino se comprime igual.
+    }
+}
+
+template CompressedGraph::CompressedGraph(const Graph&);
+template CompressedGraph::CompressedGraph(const CsrGraph&);
+
+/**
+ * @brief Obtiene el identificador del nodo de origen del grafo.
+ * @return Identificador del nodo de origen.
+ * @throws std::runtime_error si el nodo de origen no está definido.
+ */
+NodeId CompressedGraph::start_id() const {
+    if (m_start == Graph::invalid_node) {
+        throw std::runtime_error("Start node is not set");
+    }
+
+    return m_start;
+}
+
+/**
+ * @brief Obtiene el identificador del nodo de destino del grafo.
+ * @return Identificador del nodo de destino.
+ * @throws std::runtime_error si el nodo de destino no está definido.
+ */
+NodeId CompressedGraph::end_id() const {
+    if (m_end == Graph::invalid_node) {
+        throw std::runtime_error("End node is not set");
+    }
+
+    return m_end;
+}
+
+/**
+ * @brief Obtiene el número de nodos del grafo.
+ * @return Número de nodos del grafo.
+ */
+std::size_t CompressedGraph::vertex_count() const {
+    return m_heuristics.size();
+}
+
+/**
+ * @brief Obtiene el número de aristas del grafo.
+ * @return Número de aristas del grafo.
+ */
+std::size_t CompressedGraph::edge_count() const {
+    return edge_offset(static_cast<NodeId>(vertex_count()));
+}
+
+/**
+ * @brief Obtiene el identificador asignado a un nodo.
+ * @param node Nombre del nodo.
+ * @return Identificador del nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+NodeId CompressedGraph::node_id(std::string_view node) const {
+    const auto it = std::lower_bound(
+        std::cbegin(m_name_order), std::cend(m_name_order), node,
+        [this](NodeId lhs, std::string_view rhs) {
+            return node_name(lhs) < rhs;
+        });
+
+    if (it == std::cend(m_name_order) || node_name(*it) != node) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    return *it;
+}
+
+/**
+ * @brief Obtiene el nombre de un nodo a partir de su identificador.
+ * @param node Identificador del nodo.
+ * @return Nombre del nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+std::string_view CompressedGraph::node_name(NodeId node) const {
+    if (!check_node(node)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    const auto first = m_name_offsets[node];
+    return {m_names.data() + first, m_name_offsets[node + 1] - first};
+}
+
+/**
+ * @brief Obtiene el valor de la heurística para un nodo.
+ * @param node Identificador del nodo.
+ * @return Valor de la heurística.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+int CompressedGraph::get_heuristic(NodeId node) const {
+    if (!check_node(node)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    return m_heuristics[node];
+}
+
+/**
+ * @brief Obtiene el costo de una arista. La fila se decodifica hasta
+ * encontrar el destino o pasarlo, ya que está ordenada.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return Costo de la arista.
+ * @throws std::invalid_argument si alguno de los nodos no está en el grafo.
+ * @throws std::runtime_error si los nodos no están conectados.
+ */
+CompressedGraph::weight_type CompressedGraph::get_cost(NodeId from,
+                                                       NodeId to) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("From node is not in the graph");
+    }
+
+    if (!check_node(to)) {
+        throw std::invalid_argument("To node is not in the graph");
+    }
+
+    for (const auto& [node, weight] : neighbors(from)) {
+        if (node == to) {
+            return weight;
+        }
+
+        if (node > to) {
+            break;
+        }
+    }
+
+    throw std::runtime_error("Nodes are not connected");
+}
+
+/**
+ * @brief Obtiene los nodos adyacentes a un nodo, decodificándolos a medida
+ * que se recorren.
+ * @param from Identificador del nodo.
+ * @return Rango de pares (vecino, peso).
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+CompressedGraph::NeighborRange CompressedGraph::neighbors(NodeId from) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    return {this, from};
+}
+
+/**
+ * @brief Revisa si dos nodos están conectados.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return true si los nodos están conectados, false en caso contrario.
+ * @throws std::invalid_argument si alguno de los nodos no está en el grafo.
+ */
+bool CompressedGraph::are_connected(NodeId from, NodeId to) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("From node is not in the graph");
+    }
+
+    if (!check_node(to)) {
+        throw std::invalid_argument("To node is not in the graph");
+    }
+
+    for (const auto& [node, _] : neighbors(from)) {
+        if (node >= to) {
+            return node == to;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Construye el índice de alcanzabilidad del grafo, que se consulta con
+ * reachability. Si ya estaba construido o se compartió con el grafo de
+ * origen, no hace nada.
+ */
+void CompressedGraph::build_reachability() {
+    if (!m_reachability) {
+        m_reachability = std::make_shared<const ReachabilityIndex>(*this);
+    }
+}
+
+/**
+ * @brief Revisa si el índice de alcanzabilidad está disponible.
+ * @return true si ya se construyó o se compartió con el grafo de origen,
+ * false en caso contrario.
+ */
+bool CompressedGraph::has_reachability() const {
+    return m_reachability != nullptr;
+}
+
+/**
+ * @brief Obtiene el índice de alcanzabilidad del grafo.
+ * @return Índice de alcanzabilidad.
+ * @throws std::logic_error si no se ha llamado a build_reachability.
+ */
+const ReachabilityIndex& CompressedGraph::reachability() const {
+    if (!m_reachability) {
+        throw std::logic_error("Reachability index is not built");
+    }
+
+    return *m_reachability;
+}
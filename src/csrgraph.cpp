@@ -0,0 +1,781 @@
+#include "csrgraph.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+/**
+ * @brief Almacenamiento de un CsrGraph construido en memoria.
+ */
+template <typename W>
+struct OwnedArrays {
+    typename BasicCsrGraph<W>::Arrays arrays;
+    std::vector<NodeId> name_order;
+};
+
+}  // namespace
+
+/**
+ * @brief Revisa si un identificador corresponde a un nodo del grafo.
+ * @param node Identificador del nodo.
+ * @return true si el nodo está en el grafo, false en caso contrario.
+ */
+template <typename W>
+bool BasicCsrGraph<W>::check_node(NodeId node) const {
+    return node < m_heuristics.size();
+}
+
+/**
+ * @brief Busca una arista. Las filas de grado alto se resuelven con el índice
+ * hash y el resto con búsqueda binaria, ya que cada fila está ordenada por
+ * destino.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return Posición de la arista en los arreglos del grafo, o std::nullopt si
+ * los nodos no están conectados.
+ */
+template <typename W>
+std::optional<std::size_t> BasicCsrGraph<W>::find_edge(NodeId from,
+                                                       NodeId to) const {
+    const auto first = m_offsets[from];
+    const auto last = m_offsets[from + 1];
+
+    if (last - first >= EdgeIndex::hub_degree) {
+        return m_hub_edges.find(from, to);
+    }
+
+    const auto targets_begin = std::cbegin(m_targets);
+    const auto it =
+        std::lower_bound(targets_begin + first, targets_begin + last, to);
+    if (it == targets_begin + last || *it != to) {
+        return std::nullopt;
+    }
+
+    return it - targets_begin;
+}
+
+/**
+ * @brief Indexa en la tabla hash las aristas de los nodos de grado alto.
+ */
+template <typename W>
+void BasicCsrGraph<W>::build_hub_index() {
+    std::vector<std::tuple<NodeId, std::uint64_t, std::uint64_t>> hubs;
+    for (NodeId node = 0; node < vertex_count(); ++node) {
+        const auto first = m_offsets[node];
+        const auto last = m_offsets[node + 1];
+
+        if (last - first >= EdgeIndex::hub_degree) {
+            hubs.emplace_back(node, first, last);
+        }
+    }
+
+    m_hub_edges = FlatEdgeIndex::build(hubs, m_targets);
+}
+
+/**
+ * @brief Revisa que cada arista tenga su arista de vuelta, como se espera en
+ * un grafo no dirigido. Las filas ya deben estar ordenadas.
+ * @return true si la adyacencia es simétrica, false en caso contrario.
+ */
+template <typename W>
+bool BasicCsrGraph<W>::is_symmetric() const {
+    const auto targets_begin = std::cbegin(m_targets);
+
+    for (NodeId node = 0; node < vertex_count(); ++node) {
+        for (auto i = m_offsets[node]; i < m_offsets[node + 1]; ++i) {
+            const auto to = m_targets[i];
+            const auto last = targets_begin + m_offsets[to + 1];
+            const auto it =
+                std::lower_bound(targets_begin + m_offsets[to], last, node);
+            if (it == last || *it != node) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Copia la lista de adyacencia y la tabla de nodos de un grafo en los
+ * arreglos de un CsrGraph. Los identificadores de los nodos se conservan.
+ * @param graph Grafo a copiar.
+ * @return Arreglos del grafo.
+ * @throws std::out_of_range si algún peso no cabe en el tipo de los pesos.
+ */
+template <typename W>
+typename BasicCsrGraph<W>::Arrays BasicCsrGraph<W>::make_arrays(
+    const Graph& graph) {
+    const auto node_count = graph.vertex_count();
+
+    Arrays arrays;
+    arrays.offsets.reserve(node_count + 1);
+    arrays.targets.reserve(graph.edge_count());
+    arrays.weights.reserve(graph.edge_count());
+    arrays.heuristics.reserve(node_count);
+    arrays.name_offsets.reserve(node_count + 1);
+
+    arrays.offsets.push_back(0);
+    arrays.name_offsets.push_back(0);
+    for (NodeId node = 0; node < node_count; ++node) {
+        const auto& targets = graph.m_adj_targets[node];
+        const auto& weights = graph.m_adj_weights[node];
+        const auto& name = graph.m_nodes[node].name;
+
+        arrays.targets.insert(std::end(arrays.targets), std::cbegin(targets),
+                              std::cend(targets));
+        for (const auto weight : weights) {
+            if (!WeightTraits<W>::fits(weight)) {
+                throw std::out_of_range("Edge weight does not fit in the "
+                                        "weight type");
+            }
+
+            arrays.weights.push_back(static_cast<W>(weight));
+        }
+        arrays.offsets.push_back(arrays.targets.size());
+
+        arrays.heuristics.push_back(graph.m_nodes[node].heuristic);
+        arrays.names.insert(std::end(arrays.names), std::cbegin(name),
+                            std::cend(name));
+        arrays.name_offsets.push_back(arrays.names.size());
+    }
+
+    arrays.start = graph.m_start;
+    arrays.end = graph.m_end;
+    arrays.mode = graph.m_mode;
+
+    return arrays;
+}
+
+/**
+ * @brief Constructor. Congela un grafo en formato CSR. Los identificadores de
+ * los nodos se conservan.
+ * @param graph Grafo a congelar.
+ * @throws std::out_of_range si algún peso no cabe en el tipo de los pesos.
+ */
+template <typename W>
+BasicCsrGraph<W>::BasicCsrGraph(const Graph& graph)
+    : BasicCsrGraph(make_arrays(graph)) {}
+
+/**
+ * @brief Constructor. Construye el grafo a partir de sus arreglos, tomando
+ * posesión de ellos. Las filas se ordenan por destino.
+ * @param arrays Arreglos del grafo.
+ * @throws std::invalid_argument si los arreglos no son consistentes entre sí
+ * o si el grafo es no dirigido y alguna arista no tiene su arista de vuelta.
+ */
+template <typename W>
+BasicCsrGraph<W>::BasicCsrGraph(Arrays arrays) {
+    const auto node_count = arrays.heuristics.size();
+
+    if (arrays.offsets.size() != node_count + 1 ||
+        arrays.name_offsets.size() != node_count + 1 ||
+        arrays.offsets.front() != 0 || arrays.name_offsets.front() != 0 ||
+        arrays.offsets.back() != arrays.targets.size() ||
+        arrays.weights.size() != arrays.targets.size() ||
+        arrays.name_offsets.back() != arrays.names.size() ||
+        (!arrays.coordinates.empty() &&
+         arrays.coordinates.size() != node_count)) {
+        throw std::invalid_argument("Inconsistent CSR arrays");
+    }
+
+    if (std::any_of(std::cbegin(arrays.targets), std::cend(arrays.targets),
+                    [node_count](NodeId to) { return to >= node_count; })) {
+        throw std::invalid_argument("Edge target is not in the graph");
+    }
+
+    // Ordenamos cada fila por destino. El orden es estable para que, ante
+    // aristas repetidas, se siga encontrando primero la que se agregó
+    // primero.
+    std::vector<std::size_t> order;
+    std::vector<NodeId> row_targets;
+    std::vector<weight_type> row_weights;
+    for (std::size_t node = 0; node < node_count; ++node) {
+        const auto first = std::begin(arrays.targets) + arrays.offsets[node];
+        const auto last = std::begin(arrays.targets) + arrays.offsets[node + 1];
+        const auto weights = std::begin(arrays.weights) + arrays.offsets[node];
+
+        if (std::is_sorted(first, last)) {
+            continue;
+        }
+
+        order.resize(last - first);
+        std::iota(std::begin(order), std::end(order), 0);
+        std::stable_sort(std::begin(order), std::end(order),
+                         [first](std::size_t lhs, std::size_t rhs) {
+                             return first[lhs] < first[rhs];
+                         });
+
+        row_targets.assign(first, last);
+        row_weights.assign(weights, weights + (last - first));
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            first[i] = row_targets[order[i]];
+            weights[i] = row_weights[order[i]];
+        }
+    }
+
+    auto storage = std::make_shared<OwnedArrays<W>>();
+    storage->arrays = std::move(arrays);
+
+    const auto& owned = storage->arrays;
+    m_offsets = owned.offsets;
+    m_targets = owned.targets;
+    m_weights = owned.weights;
+    m_heuristics = owned.heuristics;
+    m_name_offsets = owned.name_offsets;
+    m_names = owned.names;
+    m_coordinates = owned.coordinates;
+    m_start = owned.start;
+    m_end = owned.end;
+    m_mode = owned.mode;
+
+    if (m_mode == GraphMode::undirected && !is_symmetric()) {
+        throw std::invalid_argument("Undirected graph is not symmetric");
+    }
+
+    // El orden alfabético de los nodos permite buscar un nombre con búsqueda
+    // binaria sin una tabla hash aparte.
+    auto& name_order = storage->name_order;
+    name_order.resize(node_count);
+    std::iota(std::begin(name_order), std::end(name_order), 0);
+    std::sort(std::begin(name_order), std::end(name_order),
+              [this](NodeId lhs, NodeId rhs) {
+                  return node_name(lhs) < node_name(rhs);
+              });
+    m_name_order = name_order;
+
+    m_storage = std::move(storage);
+
+    build_hub_index();
+}
+
+/**
+ * @brief Obtiene el tipo del grafo.
+ * @return GraphMode::undirected si las aristas se recorren en ambos sentidos,
+ * GraphMode::directed en caso contrario.
+ */
+template <typename W>
+GraphMode BasicCsrGraph<W>::mode() const {
+    return m_mode;
+}
+
+/**
+ * @brief Obtiene el identificador del nodo de origen del grafo.
+ * @return Identificador del nodo de origen.
+ * @throws std::runtime_error si el nodo de origen no está definido.
+ */
+template <typename W>
+NodeId BasicCsrGraph<W>::start_id() const {
+    if (m_start == Graph::invalid_node) {
+        throw std::runtime_error("Start node is not set");
+    }
+
+    return m_start;
+}
+
+/**
+ * @brief Obtiene el identificador del nodo de destino del grafo.
+ * @return Identificador del nodo de destino.
+ * @throws std::runtime_error si el nodo de destino no está definido.
+ */
+template <typename W>
+NodeId BasicCsrGraph<W>::end_id() const {
+    if (m_end == Graph::invalid_node) {
+        throw std::runtime_error("End node is not set");
+    }
+
+    return m_end;
+}
+
+/**
+ * @brief Obtiene el número de nodos del grafo.
+ * @return Número de nodos del grafo.
+ */
+template <typename W>
+std::size_t BasicCsrGraph<W>::vertex_count() const {
+    return m_heuristics.size();
+}
+
+/**
+ * @brief Obtiene el número de aristas del grafo. En un grafo no dirigido cada
+ * arista cuenta una vez por sentido (los lazos, una sola vez).
+ * @return Número de aristas del grafo.
+ */
+template <typename W>
+std::size_t BasicCsrGraph<W>::edge_count() const {
+    return m_targets.size();
+}
+
+/**
+ * @brief Obtiene el identificador asignado a un nodo.
+ * @param node Nombre del nodo.
+ * @return Identificador del nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+template <typename W>
+NodeId BasicCsrGraph<W>::node_id(std::string_view node) const {
+    const auto it = std::lower_bound(
+        std::cbegin(m_name_order), std::cend(m_name_order), node,
+        [this](NodeId lhs, std::string_view rhs) {
+            return node_name(lhs) < rhs;
+        });
+
+    if (it == std::cend(m_name_order) || node_name(*it) != node) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    return *it;
+}
+
+/**
+ * @brief Obtiene el nombre de un nodo a partir de su identificador.
+ * @param node Identificador del nodo.
+ * @return Nombre del nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+template <typename W>
+std::string_view BasicCsrGraph<W>::node_name(NodeId node) const {
+    if (!check_node(node)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    const auto first = m_name_offsets[node];
+    return {m_names.data() + first, m_name_offsets[node + 1] - first};
+}
+
+/**
+ * @brief Obtiene el valor de la heurística para un nodo.
+ * @param node Identificador del nodo.
+ * @return Valor de la heurística.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+template <typename W>
+int BasicCsrGraph<W>::get_heuristic(NodeId node) const {
+    if (!check_node(node)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    return m_heuristics[node];
+}
+
+/**
+ * @brief Indica si el grafo tiene las coordenadas de sus nodos.
+ */
+template <typename W>
+bool BasicCsrGraph<W>::has_coordinates() const {
+    return !m_coordinates.empty();
+}
+
+/**
+ * @brief Obtiene las coordenadas de un nodo.
+ * @param node Identificador del nodo.
+ * @return Coordenadas del nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ * @throws std::runtime_error si el grafo no tiene coordenadas.
+ */
+template <typename W>
+Point BasicCsrGraph<W>::get_coordinates(NodeId node) const {
+    if (!check_node(node)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    if (!has_coordinates()) {
+        throw std::runtime_error("Graph has no coordinates");
+    }
+
+    return m_coordinates[node];
+}
+
+/**
+ * @brief Obtiene el costo de una arista.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return Costo de la arista.
+ * @throws std::invalid_argument si alguno de los nodos no está en el grafo.
+ * @throws std::runtime_error si los nodos no están conectados.
+ */
+template <typename W>
+W BasicCsrGraph<W>::get_cost(NodeId from, NodeId to) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("From node is not in the graph");
+    }
+
+    if (!check_node(to)) {
+        throw std::invalid_argument("To node is not in the graph");
+    }
+
+    const auto position = find_edge(from, to);
+    if (!position) {
+        throw std::runtime_error("Nodes are not connected");
+    }
+
+    return m_weights[*position];
+}
+
+/**
+ * @brief Obtiene los nodos adyacentes a un nodo, sin copiarlos.
+ * @param from Identificador del nodo.
+ * @return Rango de pares (vecino, peso) sobre los arreglos del grafo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+template <typename W>
+BasicNeighborRange<W> BasicCsrGraph<W>::neighbors(NodeId from) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    const auto first = m_offsets[from];
+    return {m_targets.data() + first, m_weights.data() + first,
+            m_offsets[from + 1] - first};
+}
+
+/**
+ * @brief Construye la adyacencia inversa de un grafo dirigido, necesaria para
+ * in_neighbors. Se arma con un ordenamiento por conteo sobre los destinos, de
+ * modo que cada fila queda ordenada por origen. Las copias del grafo hechas
+ * después de construirla la comparten. En un grafo no dirigido no hace nada,
+ * porque la adyacencia ya es simétrica.
+ */
+template <typename W>
+void BasicCsrGraph<W>::build_reverse() {
+    if (m_mode == GraphMode::undirected || m_reverse) {
+        return;
+    }
+
+    auto reverse = std::make_shared<ReverseArrays>();
+    auto& offsets = reverse->offsets;
+    offsets.assign(vertex_count() + 1, 0);
+    for (const auto to : m_targets) {
+        offsets[to + 1]++;
+    }
+    std::partial_sum(std::cbegin(offsets), std::cend(offsets),
+                     std::begin(offsets));
+
+    // Recorrer los orígenes en orden deja cada fila ordenada por origen y,
+    // ante aristas repetidas, en el mismo orden que en la adyacencia directa.
+    std::vector<std::uint64_t> next(std::cbegin(offsets),
+                                    std::cend(offsets) - 1);
+    reverse->sources.resize(edge_count());
+    reverse->weights.resize(edge_count());
+    for (NodeId from = 0; from < vertex_count(); ++from) {
+        for (auto i = m_offsets[from]; i < m_offsets[from + 1]; ++i) {
+            const auto position = next[m_targets[i]]++;
+            reverse->sources[position] = from;
+            reverse->weights[position] = m_weights[i];
+        }
+    }
+
+    m_reverse = std::move(reverse);
+}
+
+/**
+ * @brief Revisa si in_neighbors está disponible.
+ * @return true si el grafo es no dirigido o ya se construyó su adyacencia
+ * inversa, false en caso contrario.
+ */
+template <typename W>
+bool BasicCsrGraph<W>::has_reverse() const {
+    return m_mode == GraphMode::undirected || m_reverse != nullptr;
+}
+
+/**
+ * @brief Obtiene los nodos desde los que sale una arista hacia un nodo, sin
+ * copiarlos.
+ * @param to Identificador del nodo.
+ * @return Rango de pares (origen, peso).
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ * @throws std::logic_error si el grafo es dirigido y no se ha llamado a
+ * build_reverse.
+ */
+template <typename W>
+BasicNeighborRange<W> BasicCsrGraph<W>::in_neighbors(NodeId to) const {
+    if (m_mode == GraphMode::undirected) {
+        return neighbors(to);
+    }
+
+    if (!check_node(to)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    if (!m_reverse) {
+        throw std::logic_error("Reverse adjacency is not built");
+    }
+
+    const auto first = m_reverse->offsets[to];
+    return {m_reverse->sources.data() + first,
+            m_reverse->weights.data() + first,
+            m_reverse->offsets[to + 1] - first};
+}
+
+/**
+ * @brief Construye el índice de alcanzabilidad del grafo, que se consulta con
+ * reachability. Las copias del grafo hechas después de construirlo lo
+ * comparten. Si ya estaba construido (por ejemplo, porque el grafo se leyó
+ * de un snapshot que lo incluye) no hace nada.
+ */
+template <typename W>
+void BasicCsrGraph<W>::build_reachability() {
+    if (!m_reachability) {
+        m_reachability = std::make_shared<const ReachabilityIndex>(*this);
+    }
+}
+
+/**
+ * @brief Revisa si el índice de alcanzabilidad está disponible.
+ * @return true si ya se construyó o se leyó del snapshot, false en caso
+ * contrario.
+ */
+template <typename W>
+bool BasicCsrGraph<W>::has_reachability() const {
+    return m_reachability != nullptr;
+}
+
+/**
+ * @brief Obtiene el índice de alcanzabilidad del grafo.
+ * @return Índice de alcanzabilidad.
+ * @throws std::logic_error si no se ha llamado a build_reachability.
+ */
+template <typename W>
+const ReachabilityIndex& BasicCsrGraph<W>::reachability() const {
+    if (!m_reachability) {
+        throw std::logic_error("Reachability index is not built");
+    }
+
+    return *m_reachability;
+}
+
+/**
+ * @brief Revisa si dos nodos están conectados.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return true si los nodos están conectados, false en caso contrario.
+ * @throws std::invalid_argument si alguno de los nodos no está en el grafo.
+ */
+template <typename W>
+bool BasicCsrGraph<W>::are_connected(NodeId from, NodeId to) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("From node is not in the graph");
+    }
+
+    if (!check_node(to)) {
+        throw std::invalid_argument("To node is not in the graph");
+    }
+
+    return find_edge(from, to).has_value();
+}
+
+/**
+ * @brief Cambia el peso de un lote de aristas sin reconstruir el grafo. Si hay
+ * aristas repetidas entre los mismos nodos, se actualizan todas. En un grafo
+ * no dirigido se actualizan ambos sentidos de la arista, y en uno dirigido
+ * también la adyacencia inversa, si existe.
+ *
+ * La primera vez que se modifican los pesos se copian a un arreglo propio de
+ * este objeto (los originales pueden estar compartidos con otras copias o en
+ * un archivo mapeado); de ahí en adelante se actualizan en el mismo lugar.
+ * Cada lote incrementa la versión de los pesos, que pueden consultar los
+ * cachés que dependan de ellos. El lote se valida completo antes de aplicar
+ * cualquier cambio.
+ *
+ * @param updates Cambios a aplicar.
+ * @return Nueva versión de los pesos.
+ * @throws std::invalid_argument si algún nodo no está en el grafo o alguna
+ * arista no existe.
+ */
+template <typename W>
+std::uint64_t BasicCsrGraph<W>::update_weights(
+    const std::vector<WeightUpdate>& updates) {
+    std::vector<std::size_t> positions;
+    positions.reserve(updates.size());
+
+    for (const auto& update : updates) {
+        if (!check_node(update.from) || !check_node(update.to)) {
+            throw std::invalid_argument("Node is not in the graph");
+        }
+
+        const auto position = find_edge(update.from, update.to);
+        if (!position) {
+            throw std::invalid_argument("Nodes are not connected");
+        }
+
+        positions.push_back(*position);
+    }
+
+    if (!m_updated_weights || m_updated_weights.use_count() > 1) {
+        m_updated_weights = std::make_shared<std::vector<weight_type>>(
+            std::cbegin(m_weights), std::cend(m_weights));
+        m_weights = *m_updated_weights;
+    }
+
+    if (m_reverse && m_reverse.use_count() > 1) {
+        m_reverse = std::make_shared<ReverseArrays>(*m_reverse);
+    }
+
+    auto& weights = *m_updated_weights;
+    for (std::size_t i = 0; i < updates.size(); ++i) {
+        const auto& update = updates[i];
+        const auto last = m_offsets[update.from + 1];
+
+        // Las filas están ordenadas, así que las aristas repetidas quedan
+        // juntas a partir de la primera.
+        for (auto j = positions[i]; j < last && m_targets[j] == update.to;
+             ++j) {
+            weights[j] = update.weight;
+        }
+
+        if (m_mode == GraphMode::undirected) {
+            const auto back_last = m_offsets[update.to + 1];
+            for (auto j = *find_edge(update.to, update.from);
+                 j < back_last && m_targets[j] == update.from; ++j) {
+                weights[j] = update.weight;
+            }
+        } else if (m_reverse) {
+            const auto sources = std::cbegin(m_reverse->sources);
+            const auto back_first = sources + m_reverse->offsets[update.to];
+            const auto back_last = sources + m_reverse->offsets[update.to + 1];
+            for (auto it = std::lower_bound(back_first, back_last, update.from);
+                 it != back_last && *it == update.from; ++it) {
+                m_reverse->weights[it - sources] = update.weight;
+            }
+        }
+    }
+
+    return ++m_weight_version;
+}
+
+/**
+ * @brief Obtiene la versión actual de los pesos. Comienza en 0 y aumenta en
+ * uno con cada lote aplicado con update_weights.
+ */
+template <typename W>
+std::uint64_t BasicCsrGraph<W>::weight_version() const {
+    return m_weight_version;
+}
+
+/**
+ * @brief Obtiene el arreglo de inicios de fila (`vertex_count() + 1`
+ * elementos).
+ */
+template <typename W>
+ArrayView<std::uint64_t> BasicCsrGraph<W>::offsets() const {
+    return m_offsets;
+}
+
+/**
+ * @brief Obtiene el arreglo de destinos de las aristas.
+ */
+template <typename W>
+ArrayView<NodeId> BasicCsrGraph<W>::targets() const {
+    return m_targets;
+}
+
+/**
+ * @brief Obtiene el arreglo de pesos de las aristas.
+ */
+template <typename W>
+ArrayView<W> BasicCsrGraph<W>::weights() const {
+    return m_weights;
+}
+
+/**
+ * @brief Obtiene el arreglo de heurísticas de los nodos.
+ */
+template <typename W>
+ArrayView<int> BasicCsrGraph<W>::heuristics() const {
+    return m_heuristics;
+}
+
+/**
+ * @brief Obtiene el arreglo de inicios de los nombres dentro de names()
+ * (`vertex_count() + 1` elementos).
+ */
+template <typename W>
+ArrayView<std::uint64_t> BasicCsrGraph<W>::name_offsets() const {
+    return m_name_offsets;
+}
+
+/**
+ * @brief Obtiene los nombres de los nodos, concatenados.
+ */
+template <typename W>
+ArrayView<char> BasicCsrGraph<W>::names() const {
+    return m_names;
+}
+
+/**
+ * @brief Obtiene los identificadores de los nodos ordenados por nombre.
+ */
+template <typename W>
+ArrayView<NodeId> BasicCsrGraph<W>::name_order() const {
+    return m_name_order;
+}
+
+/**
+ * @brief Obtiene las coordenadas de los nodos, o un arreglo vacío si el grafo
+ * no las tiene.
+ */
+template <typename W>
+ArrayView<Point> BasicCsrGraph<W>::coordinates() const {
+    return m_coordinates;
+}
+
+/**
+ * @brief Copia un grafo cambiando el tipo de sus pesos. Los nodos, nombres,
+ * heurísticas y coordenadas se conservan.
+ * @param graph Grafo a copiar.
+ * @return Grafo con pesos de tipo `W`.
+ * @throws std::out_of_range si algún peso no cabe en el tipo `W`.
+ */
+template <typename W>
+BasicCsrGraph<W> convert_weights(const CsrGraph& graph) {
+    typename BasicCsrGraph<W>::Arrays arrays;
+    arrays.offsets.assign(std::cbegin(graph.offsets()),
+                          std::cend(graph.offsets()));
+    arrays.targets.assign(std::cbegin(graph.targets()),
+                          std::cend(graph.targets()));
+    arrays.heuristics.assign(std::cbegin(graph.heuristics()),
+                             std::cend(graph.heuristics()));
+    arrays.name_offsets.assign(std::cbegin(graph.name_offsets()),
+                               std::cend(graph.name_offsets()));
+    arrays.names.assign(std::cbegin(graph.names()), std::cend(graph.names()));
+    arrays.coordinates.assign(std::cbegin(graph.coordinates()),
+                              std::cend(graph.coordinates()));
+    arrays.mode = graph.mode();
+
+    arrays.weights.reserve(graph.edge_count());
+    for (const auto weight : graph.weights()) {
+        if (!WeightTraits<W>::fits(weight)) {
+            throw std::out_of_range("Edge weight does not fit in the weight "
+                                    "type");
+        }
+
+        arrays.weights.push_back(static_cast<W>(weight));
+    }
+
+    try {
+        arrays.start = graph.start_id();
+        arrays.end = graph.end_id();
+    } catch (const std::runtime_error&) {
+        // Un grafo sin origen o destino se convierte igual.
+    }
+
+    return BasicCsrGraph<W>(std::move(arrays));
+}
+
+template class BasicCsrGraph<int>;
+template class BasicCsrGraph<std::uint16_t>;
+template class BasicCsrGraph<std::uint32_t>;
+template class BasicCsrGraph<std::uint64_t>;
+template class BasicCsrGraph<float>;
+
+template BasicCsrGraph<int> convert_weights<int>(const CsrGraph&);
+template BasicCsrGraph<std::uint16_t> convert_weights<std::uint16_t>(
+    const CsrGraph&);
+template BasicCsrGraph<std::uint32_t> convert_weights<std::uint32_t>(
+    const CsrGraph&);
+template BasicCsrGraph<std::uint64_t> convert_weights<std::uint64_t>(
+    const CsrGraph&);
+template BasicCsrGraph<float> convert_weights<float>(const CsrGraph&);
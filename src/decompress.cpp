@@ -0,0 +1,322 @@
+#include "decompress.h"
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr unsigned char gzip_magic[] = {0x1f, 0x8b};
+constexpr unsigned char zstd_magic[] = {0x28, 0xb5, 0x2f, 0xfd};
+
+constexpr std::size_t input_block_size = 1 << 16;
+
+/**
+ * @brief Recibe cada bloque descomprimido; devuelve false si ya no se quieren
+ * más bloques.
+ */
+using BlockSink = std::function<bool(std::vector<char>)>;
+
+#ifdef HAVE_ZLIB
+/**
+ * @brief Descomprime un archivo gzip. Un archivo puede tener varios miembros
+ * concatenados, que se descomprimen uno tras otro.
+ */
+void inflate_gzip(std::ifstream& in, const std::string& path,
+                  std::size_t block_size, const BlockSink& sink) {
+    z_stream stream{};
+    // 15 bits de ventana, más 16 para aceptar solo la cabecera gzip.
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+        throw std::runtime_error("Cannot initialize gzip decompression");
+    }
+
+    std::vector<char> input(input_block_size);
+    std::vector<char> output(block_size);
+    bool member_done = false;
+
+    // Si una llamada llenó el bloque de salida, zlib puede tener salida
+    // pendiente aunque no quede entrada.
+    bool output_full = false;
+
+    try {
+        while (true) {
+            if (stream.avail_in == 0 && !output_full) {
+                in.read(input.data(), input.size());
+                if (in.bad()) {
+                    throw std::runtime_error("Cannot read " + path);
+                }
+
+                if (in.gcount() == 0) {
+                    break;
+                }
+
+                stream.next_in = reinterpret_cast<Bytef*>(input.data());
+                stream.avail_in = static_cast<uInt>(in.gcount());
+            }
+
+            // Tras el fin de un miembro, los bytes que siguen empiezan el
+            // siguiente.
+            if (member_done) {
+                inflateReset(&stream);
+                member_done = false;
+            }
+
+            stream.next_out = reinterpret_cast<Bytef*>(output.data());
+            stream.avail_out = static_cast<uInt>(output.size());
+
+            const int result = inflate(&stream, Z_NO_FLUSH);
+            if (result != Z_OK && result != Z_STREAM_END &&
+                result != Z_BUF_ERROR) {
+                throw std::runtime_error(path + " is not valid gzip data");
+            }
+
+            output_full = stream.avail_out == 0;
+            member_done = result == Z_STREAM_END;
+
+            const auto produced = output.size() - stream.avail_out;
+            if (produced > 0) {
+                output.resize(produced);
+                if (!sink(std::move(output))) {
+                    inflateEnd(&stream);
+                    return;
+                }
+                output = std::vector<char>(block_size);
+            }
+        }
+
+        if (!member_done && stream.total_in > 0) {
+            throw std::runtime_error(path + " is truncated");
+        }
+    } catch (...) {
+        inflateEnd(&stream);
+        throw;
+    }
+
+    inflateEnd(&stream);
+}
+#endif
+
+#ifdef HAVE_ZSTD
+/**
+ * @brief Descomprime un archivo zstd, con uno o varios frames.
+ */
+void decompress_zstd(std::ifstream& in, const std::string& path,
+                     std::size_t block_size, const BlockSink& sink) {
+    const std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream(
+        ZSTD_createDStream(), &ZSTD_freeDStream);
+    if (!stream || ZSTD_isError(ZSTD_initDStream(stream.get()))) {
+        throw std::runtime_error("Cannot initialize zstd decompression");
+    }
+
+    std::vector<char> input(input_block_size);
+    ZSTD_inBuffer source{input.data(), 0, 0};
+    std::size_t pending = 0;
+
+    // Si una llamada llenó el bloque de salida, zstd puede tener salida
+    // pendiente aunque no quede entrada.
+    bool output_full = false;
+
+    while (true) {
+        if (source.pos == source.size && !output_full) {
+            in.read(input.data(), input.size());
+            if (in.bad()) {
+                throw std::runtime_error("Cannot read " + path);
+            }
+
+            if (in.gcount() == 0) {
+                break;
+            }
+
+            source = {input.data(), static_cast<std::size_t>(in.gcount()), 0};
+        }
+
+        std::vector<char> output(block_size);
+        ZSTD_outBuffer target{output.data(), output.size(), 0};
+
+        pending = ZSTD_decompressStream(stream.get(), &target, &source);
+        if (ZSTD_isError(pending)) {
+            throw std::runtime_error(path + " is not valid zstd data");
+        }
+
+        output_full = target.pos == target.size;
+        if (target.pos > 0) {
+            output.resize(target.pos);
+            if (!sink(std::move(output))) {
+                return;
+            }
+        }
+    }
+
+    // Un resultado distinto de 0 indica que el último frame no terminó.
+    if (pending != 0) {
+        throw std::runtime_error(path + " is truncated");
+    }
+}
+#endif
+
+}  // namespace
+
+/**
+ * @brief Reconoce el formato de compresión de un archivo por su firma.
+ * @param path Ruta del archivo.
+ * @return Formato del archivo; Compression::none si no tiene una firma
+ * conocida o no se puede leer.
+ */
+Compression detect_compression(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+
+    unsigned char magic[sizeof(zstd_magic)] = {};
+    in.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    const auto size = static_cast<std::size_t>(in.gcount());
+
+    if (size >= sizeof(gzip_magic) &&
+        std::memcmp(magic, gzip_magic, sizeof(gzip_magic)) == 0) {
+        return Compression::gzip;
+    }
+
+    if (size >= sizeof(zstd_magic) &&
+        std::memcmp(magic, zstd_magic, sizeof(zstd_magic)) == 0) {
+        return Compression::zstd;
+    }
+
+    return Compression::none;
+}
+
+/**
+ * @brief Constructor. Abre el archivo y empieza a descomprimirlo en otro
+ * hilo.
+ * @param path Ruta del archivo.
+ * @param kind Formato de compresión del archivo.
+ * @throws std::runtime_error si no se puede abrir el archivo o el programa
+ * se compiló sin soporte para el formato.
+ */
+DecompressStreambuf::DecompressStreambuf(const std::string& path,
+                                         Compression kind) {
+#ifndef HAVE_ZLIB
+    if (kind == Compression::gzip) {
+        throw std::runtime_error(path + " is gzip-compressed, but gzip "
+                                        "support was not compiled in");
+    }
+#endif
+#ifndef HAVE_ZSTD
+    if (kind == Compression::zstd) {
+        throw std::runtime_error(path + " is zstd-compressed, but zstd "
+                                        "support was not compiled in");
+    }
+#endif
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+
+    m_thread = std::thread(&DecompressStreambuf::produce, this, std::move(in),
+                           path, kind);
+}
+
+/**
+ * @brief Destructor. Si el lector no llegó al final, detiene el hilo de
+ * descompresión y espera a que termine.
+ */
+DecompressStreambuf::~DecompressStreambuf() {
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_space.notify_all();
+
+    m_thread.join();
+}
+
+/**
+ * @brief Deja un bloque en la cola, esperando si está llena.
+ * @return false si el lector ya se cerró y no quiere más bloques.
+ */
+bool DecompressStreambuf::push(std::vector<char> block) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_space.wait(lock, [this] {
+        return m_closed || m_blocks.size() < max_blocks;
+    });
+
+    if (m_closed) {
+        return false;
+    }
+
+    m_blocks.push_back(std::move(block));
+    lock.unlock();
+    m_ready.notify_one();
+
+    return true;
+}
+
+/**
+ * @brief Cuerpo del hilo de descompresión.
+ */
+void DecompressStreambuf::produce(std::ifstream in, const std::string& path,
+                                  Compression kind) {
+    std::exception_ptr error;
+    try {
+        const BlockSink sink = [this](std::vector<char> block) {
+            return push(std::move(block));
+        };
+
+#ifdef HAVE_ZLIB
+        if (kind == Compression::gzip) {
+            inflate_gzip(in, path, block_size, sink);
+        }
+#endif
+#ifdef HAVE_ZSTD
+        if (kind == Compression::zstd) {
+            decompress_zstd(in, path, block_size, sink);
+        }
+#endif
+        (void)kind;
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+        m_error = error;
+    }
+    m_ready.notify_one();
+}
+
+/**
+ * @brief Toma el siguiente bloque descomprimido, esperando a que el hilo de
+ * descompresión lo produzca.
+ * @throws La excepción del hilo de descompresión, si falló.
+ */
+DecompressStreambuf::int_type DecompressStreambuf::underflow() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_ready.wait(lock, [this] { return m_done || !m_blocks.empty(); });
+
+    if (m_blocks.empty()) {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+
+        return traits_type::eof();
+    }
+
+    m_current = std::move(m_blocks.front());
+    m_blocks.pop_front();
+    lock.unlock();
+    m_space.notify_one();
+
+    setg(m_current.data(), m_current.data(),
+         m_current.data() + m_current.size());
+
+    return traits_type::to_int_type(m_current.front());
+}
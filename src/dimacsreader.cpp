@@ -0,0 +1,415 @@
+#include "dimacsreader.h"
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "mappedfile.h"
+
+/*
+ * Formato del 9th DIMACS Implementation Challenge (caminos más cortos). Un
+ * archivo .gr tiene la forma
+ *
+ *   c <comentario>
+ *   p sp <nodos> <arcos>
+ *   a <origen> <destino> <peso>
+ *
+ * y un archivo .co, con las coordenadas de los nodos,
+ *
+ *   c <comentario>
+ *   p aux sp co <nodos>
+ *   v <nodo> <x> <y>
+ *
+ * Los nodos se numeran desde 1, así que el nodo `n` del archivo es el
+ * identificador `n - 1` y su nombre es el número en decimal. Las coordenadas
+ * son la longitud y la latitud en millonésimas de grado; se guardan en
+ * grados.
+ */
+
+namespace {
+
+/**
+ * @brief Construye un error que indica el archivo, la línea y la columna
+ * (ambas desde 1) en que se produjo.
+ */
+std::runtime_error parse_error(const std::string& source, std::size_t line,
+                               std::size_t column, const std::string& what) {
+    return std::runtime_error(source + ":" + std::to_string(line) + ":" +
+                              std::to_string(column) + ": " + what);
+}
+
+/**
+ * @brief Recorre las líneas de un archivo mapeado en memoria y los campos
+ * separados por espacios de cada línea.
+ */
+class DimacsLines {
+private:
+    const std::string& m_source;
+    std::string_view m_text;
+    std::string_view m_line;
+    std::size_t m_pos = 0;
+    std::size_t m_field = 0;
+    std::size_t m_column = 0;
+    std::size_t m_number = 0;
+
+    static bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+public:
+    DimacsLines(const std::string& source, std::string_view text)
+        : m_source(source), m_text(text) {}
+
+    /**
+     * @brief Avanza a la siguiente línea.
+     * @return El tipo de la línea (su primer carácter), '\0' si está vacía,
+     * o std::nullopt al final del archivo.
+     */
+    std::optional<char> next() {
+        if (m_pos >= m_text.size()) {
+            return std::nullopt;
+        }
+
+        auto end = m_text.find('\n', m_pos);
+        if (end == std::string_view::npos) {
+            end = m_text.size();
+        }
+
+        m_line = m_text.substr(m_pos, end - m_pos);
+        m_pos = end + 1;
+        m_field = 0;
+        m_number++;
+
+        const auto type = field();
+        return type.empty() ? '\0' : type.front();
+    }
+
+    /**
+     * @brief Obtiene el siguiente campo de la línea, o una vista vacía si no
+     * quedan campos.
+     */
+    std::string_view field() {
+        while (m_field < m_line.size() && is_space(m_line[m_field])) {
+            ++m_field;
+        }
+
+        const auto begin = m_field;
+        while (m_field < m_line.size() && !is_space(m_line[m_field])) {
+            ++m_field;
+        }
+
+        return m_line.substr(begin, m_field - begin);
+    }
+
+    /**
+     * @brief Lee el siguiente campo como un número.
+     * @throws std::runtime_error si el campo falta o no es un número de tipo
+     * `T`.
+     */
+    template <typename T>
+    T number(const char* what) {
+        const auto text = field();
+        m_column = text.data() - m_line.data() + 1;
+        if (text.empty()) {
+            throw error(m_column, std::string("expected ") + what);
+        }
+
+        T value{};
+        const auto* last = text.data() + text.size();
+        const auto [end, ec] = std::from_chars(text.data(), last, value);
+        if (ec == std::errc::result_out_of_range) {
+            throw error(m_column, std::string(what) + " is out of range");
+        }
+        if (ec != std::errc() || end != last) {
+            throw error(m_column, std::string("expected ") + what);
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Lee el siguiente campo como un nodo del archivo.
+     * @return Identificador del nodo.
+     */
+    NodeId node(std::uint64_t node_count) {
+        const auto value = number<std::uint64_t>("node");
+        if (value == 0 || value > node_count) {
+            throw error(m_column, "node " + std::to_string(value) +
+                                      " is not in the graph");
+        }
+
+        return static_cast<NodeId>(value - 1);
+    }
+
+    /**
+     * @brief Columna (desde 1) del último número leído.
+     */
+    std::size_t column() const { return m_column; }
+
+    std::runtime_error error(std::size_t column,
+                             const std::string& what) const {
+        return parse_error(m_source, m_number, column, what);
+    }
+
+    std::runtime_error error(const std::string& what) const {
+        return error(1, what);
+    }
+};
+
+/**
+ * @brief Resuelve el nombre de un nodo (su número en el archivo).
+ */
+NodeId parse_terminal(const std::string& name, std::uint64_t node_count,
+                      const char* what) {
+    std::uint64_t value = 0;
+    const auto* last = name.data() + name.size();
+    const auto [end, ec] = std::from_chars(name.data(), last, value);
+    if (ec != std::errc() || end != last || value == 0 || value > node_count) {
+        throw std::invalid_argument(std::string(what) + " node '" + name +
+                                    "' is not in the graph");
+    }
+
+    return static_cast<NodeId>(value - 1);
+}
+
+/**
+ * @brief Arco leído del archivo .gr.
+ */
+struct Arc {
+    NodeId from;
+    NodeId to;
+    int weight;
+};
+
+/**
+ * @brief Lee los arcos de un archivo .gr.
+ * @return Número de nodos y los arcos, en el orden del archivo.
+ */
+std::pair<std::uint64_t, std::vector<Arc>> read_arcs(const std::string& path) {
+    const MappedFile file(path);
+    DimacsLines lines(path, {file.data(), file.size()});
+
+    std::uint64_t node_count = 0;
+    std::uint64_t arc_count = 0;
+    bool has_header = false;
+    std::vector<Arc> arcs;
+
+    while (const auto type = lines.next()) {
+        if (*type == 'c' || *type == '\0') {
+            continue;
+        }
+
+        if (*type == 'p') {
+            if (has_header) {
+                throw lines.error("duplicate 'p' line");
+            }
+
+            if (lines.field() != "sp") {
+                throw lines.error("expected 'p sp <nodes> <arcs>'");
+            }
+
+            node_count = lines.number<std::uint64_t>("node count");
+            arc_count = lines.number<std::uint64_t>("arc count");
+            if (node_count >= Graph::invalid_node) {
+                throw lines.error("too many nodes");
+            }
+
+            // La cabecera da el número exacto de arcos, así que el arreglo
+            // se reserva una sola vez.
+            arcs.reserve(arc_count);
+            has_header = true;
+        } else if (*type == 'a') {
+            if (!has_header) {
+                throw lines.error("arc before the 'p' line");
+            }
+
+            if (arcs.size() == arc_count) {
+                throw lines.error("more arcs than declared");
+            }
+
+            const auto from = lines.node(node_count);
+            const auto to = lines.node(node_count);
+            const auto weight = lines.number<int>("weight");
+            if (weight < 0) {
+                throw lines.error(lines.column(),
+                                  "weight must not be negative");
+            }
+
+            arcs.push_back({from, to, weight});
+        } else {
+            throw lines.error(std::string("unknown line type '") + *type +
+                              "'");
+        }
+    }
+
+    if (!has_header) {
+        throw std::runtime_error(path + ": missing 'p sp' line");
+    }
+
+    if (arcs.size() != arc_count) {
+        throw std::runtime_error(path + ": expected " +
+                                 std::to_string(arc_count) + " arcs, found " +
+                                 std::to_string(arcs.size()));
+    }
+
+    return {node_count, std::move(arcs)};
+}
+
+/**
+ * @brief Lee las coordenadas de un archivo .co.
+ * @param node_count Número de nodos del grafo; el archivo debe tener las
+ * coordenadas de todos.
+ */
+std::vector<Point> read_coordinates(const std::string& path,
+                                    std::uint64_t node_count) {
+    const MappedFile file(path);
+    DimacsLines lines(path, {file.data(), file.size()});
+
+    std::vector<Point> coordinates(node_count);
+    std::vector<bool> seen(node_count, false);
+    std::uint64_t count = 0;
+    bool has_header = false;
+
+    while (const auto type = lines.next()) {
+        if (*type == 'c' || *type == '\0') {
+            continue;
+        }
+
+        if (*type == 'p') {
+            if (has_header) {
+                throw lines.error("duplicate 'p' line");
+            }
+
+            if (lines.field() != "aux" || lines.field() != "sp" ||
+                lines.field() != "co") {
+                throw lines.error("expected 'p aux sp co <nodes>'");
+            }
+
+            if (lines.number<std::uint64_t>("node count") != node_count) {
+                throw lines.error("node count does not match the graph");
+            }
+
+            has_header = true;
+        } else if (*type == 'v') {
+            if (!has_header) {
+                throw lines.error("coordinates before the 'p' line");
+            }
+
+            const auto node = lines.node(node_count);
+            if (seen[node]) {
+                throw lines.error("node " + std::to_string(node + 1) +
+                                  " already has coordinates");
+            }
+
+            const auto x = lines.number<std::int64_t>("x coordinate");
+            const auto y = lines.number<std::int64_t>("y coordinate");
+
+            coordinates[node] = {static_cast<double>(x) / 1e6,
+                                 static_cast<double>(y) / 1e6};
+            seen[node] = true;
+            count++;
+        } else {
+            throw lines.error(std::string("unknown line type '") + *type +
+                              "'");
+        }
+    }
+
+    if (count != node_count) {
+        throw std::runtime_error(path + ": expected coordinates for " +
+                                 std::to_string(node_count) + " nodes, found " +
+                                 std::to_string(count));
+    }
+
+    return coordinates;
+}
+
+}  // namespace
+
+/**
+ * @brief Lee un grafo en el formato del DIMACS Challenge y lo entrega ya
+ * congelado. Los arcos se reparten por origen con un ordenamiento por conteo
+ * directamente en los arreglos del CSR, que se reservan con los tamaños que
+ * indica la cabecera. El formato no trae heurísticas, así que todas valen 0.
+ * @param gr_path Ruta del archivo .gr con los arcos.
+ * @param co_path Ruta del archivo .co con las coordenadas, o una cadena vacía
+ * si no se usan.
+ * @param start Número del nodo de origen.
+ * @param end Número del nodo de destino.
+ * @param mode Indica si los arcos tienen dirección. En un grafo no dirigido
+ * cada arco se puede recorrer en ambos sentidos.
+ * @return Grafo leído.
+ * @throws std::runtime_error si algún archivo no se puede abrir o no tiene el
+ * formato esperado.
+ * @throws std::invalid_argument si el origen o el destino no están en el
+ * grafo.
+ */
+CsrGraph read_dimacs(const std::string& gr_path, const std::string& co_path,
+                     const std::string& start, const std::string& end,
+                     GraphMode mode) {
+    auto [node_count, arcs] = read_arcs(gr_path);
+    const bool undirected = mode == GraphMode::undirected;
+
+    CsrGraph::Arrays arrays;
+    arrays.start = parse_terminal(start, node_count, "start");
+    arrays.end = parse_terminal(end, node_count, "end");
+    arrays.mode = mode;
+
+    // Contar las aristas de cada origen y convertir los conteos en la
+    // posición donde empieza cada fila.
+    arrays.offsets.assign(node_count + 1, 0);
+    for (const auto& arc : arcs) {
+        arrays.offsets[arc.from + 1]++;
+        if (undirected && arc.from != arc.to) {
+            arrays.offsets[arc.to + 1]++;
+        }
+    }
+
+    for (std::uint64_t node = 0; node < node_count; ++node) {
+        arrays.offsets[node + 1] += arrays.offsets[node];
+    }
+
+    const auto edge_count = arrays.offsets[node_count];
+    arrays.targets.resize(edge_count);
+    arrays.weights.resize(edge_count);
+
+    std::vector<std::uint64_t> next(std::cbegin(arrays.offsets),
+                                    std::cend(arrays.offsets) - 1);
+    for (const auto& arc : arcs) {
+        const auto position = next[arc.from]++;
+        arrays.targets[position] = arc.to;
+        arrays.weights[position] = arc.weight;
+
+        if (undirected && arc.from != arc.to) {
+            const auto back = next[arc.to]++;
+            arrays.targets[back] = arc.from;
+            arrays.weights[back] = arc.weight;
+        }
+    }
+
+    arcs = {};
+    next = {};
+
+    arrays.heuristics.assign(node_count, 0);
+
+    // El nombre de cada nodo es su número en el archivo.
+    arrays.name_offsets.reserve(node_count + 1);
+    arrays.name_offsets.push_back(0);
+    for (std::uint64_t node = 1; node <= node_count; ++node) {
+        char buffer[20];
+        const auto [last, ec] =
+            std::to_chars(buffer, buffer + sizeof(buffer), node);
+
+        arrays.names.insert(std::end(arrays.names), buffer, last);
+        arrays.name_offsets.push_back(arrays.names.size());
+    }
+
+    if (!co_path.empty()) {
+        arrays.coordinates = read_coordinates(co_path, node_count);
+    }
+
+    return CsrGraph(std::move(arrays));
+}
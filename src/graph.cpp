@@ -1,26 +1,232 @@
 #include "graph.h"
 
+#include <charconv>
+#include <system_error>
+
+/**
+ * @brief Obtiene el valor de un nombre numérico. Un nombre con ceros a la
+ * izquierda no es numérico, porque "07" y "7" son nodos distintos.
+ * @param name Nombre del nodo.
+ * @return Valor del nombre, o std::nullopt si no es numérico.
+ */
+std::optional<std::uint64_t> Graph::numeric_name(std::string_view name) {
+    if (name.size() > 1 && name.front() == '0') {
+        return std::nullopt;
+    }
+
+    std::uint64_t value = 0;
+    const auto* last = name.data() + name.size();
+    const auto [end, ec] = std::from_chars(name.data(), last, value);
+    if (ec != std::errc() || end != last) {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+/**
+ * @brief Busca un nodo por su nombre. Los nombres numéricos se buscan primero
+ * en la tabla indexada por su valor, y en la tabla hash solo si pueden estar
+ * en ella.
+ * @param name Nombre del nodo.
+ * @return Identificador del nodo, o std::nullopt si no está en el grafo.
+ */
+std::optional<NodeId> Graph::find_node(std::string_view name) const {
+    if (const auto value = numeric_name(name)) {
+        if (*value < m_numeric_ids.size() &&
+            m_numeric_ids[*value] != invalid_node) {
+            return m_numeric_ids[*value];
+        }
+
+        if (*value < m_min_hashed_numeric) {
+            return std::nullopt;
+        }
+    }
+
+    const auto id_it = m_node_ids.find(name);
+    if (id_it == std::cend(m_node_ids)) {
+        return std::nullopt;
+    }
+
+    return id_it->second;
+}
+
 /**
  * @brief Revisa si un nodo está en el grafo.
  * @param node_name Nombre del nodo a buscar.
  * @return true si el nodo está en el grafo, false en caso contrario.
  */
-bool Graph::check_node(const std::string& node_name) const {
-    const auto node_it = std::find_if(
-        std::cbegin(m_nodes), std::cend(m_nodes),
-        [&node_name](const auto& node) { return node.name == node_name; });
+bool Graph::check_node(std::string_view node_name) const {
+    return find_node(node_name).has_value();
+}
 
-    return node_it != std::cend(m_nodes);
+/**
+ * @brief Revisa si un identificador corresponde a un nodo del grafo.
+ * @param node Identificador del nodo.
+ * @return true si el nodo está en el grafo, false en caso contrario.
+ */
+bool Graph::check_node(NodeId node) const {
+    return node < m_nodes.size();
 }
 
 /**
- * @brief Agrega un nodo al grafo. El nodo es creado sin aristas.
+ * @brief Busca una arista en la lista de adyacencia de su nodo de origen. Los
+ * nodos de grado alto se resuelven con el índice hash; el resto, con un
+ * recorrido lineal de su lista.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return Posición de la arista dentro de la lista de `from`, o std::nullopt
+ * si los nodos no están conectados.
+ */
+std::optional<std::size_t> Graph::find_edge(NodeId from, NodeId to) const {
+    const auto& targets = m_adj_targets[from];
+
+    if (targets.size() >= EdgeIndex::hub_degree) {
+        return m_hub_edges.find(from, to);
+    }
+
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        if (targets[i] == to) {
+            return i;
+        }
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Agrega una entrada a la lista de adyacencia de un nodo.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @param weight Peso de la arista.
+ */
+void Graph::append_edge(NodeId from, NodeId to, int weight) {
+    auto& targets = m_adj_targets[from];
+    targets.push_back(to);
+    m_adj_weights[from].push_back(weight);
+    m_edge_count++;
+
+    // Al alcanzar el grado umbral se indexan todas las aristas del nodo; de
+    // ahí en adelante, cada arista nueva se indexa al agregarse.
+    if (targets.size() == EdgeIndex::hub_degree) {
+        for (std::size_t i = 0; i < targets.size(); ++i) {
+            m_hub_edges.insert(from, targets[i], i);
+        }
+    } else if (targets.size() > EdgeIndex::hub_degree) {
+        m_hub_edges.insert(from, to, targets.size() - 1);
+    }
+}
+
+/**
+ * @brief Vuelve a armar la tabla de nombres a partir de `m_nodes`, con vistas
+ * de los nombres guardados en este grafo. Los nombres que están en la tabla
+ * numérica no se agregan.
+ */
+void Graph::index_names() {
+    const auto numeric_count = static_cast<std::size_t>(
+        std::count_if(std::cbegin(m_numeric_ids), std::cend(m_numeric_ids),
+                      [](NodeId id) { return id != invalid_node; }));
+
+    m_node_ids.clear();
+    m_node_ids.reserve(m_nodes.size() - numeric_count);
+    for (NodeId node = 0; node < m_nodes.size(); ++node) {
+        const auto value = numeric_name(m_nodes[node].name);
+        if (value && *value < m_numeric_ids.size() &&
+            m_numeric_ids[*value] == node) {
+            continue;
+        }
+
+        m_node_ids.emplace(m_nodes[node].name, node);
+    }
+}
+
+/**
+ * @brief Constructor. Crea un grafo vacío.
+ * @param mode Indica si las aristas tienen dirección.
+ */
+Graph::Graph(GraphMode mode) : m_mode(mode) {}
+
+/**
+ * @brief Constructor de copia. La tabla hash de nombres no se copia, porque
+ * sus claves apuntan a los nombres del otro grafo; se arma de nuevo. La
+ * tabla de nombres numéricos solo guarda identificadores, así que se copia.
+ * @param other Grafo a copiar.
+ */
+Graph::Graph(const Graph& other)
+    : m_nodes(other.m_nodes),
+      m_numeric_ids(other.m_numeric_ids),
+      m_min_hashed_numeric(other.m_min_hashed_numeric),
+      m_adj_targets(other.m_adj_targets),
+      m_adj_weights(other.m_adj_weights),
+      m_hub_edges(other.m_hub_edges),
+      m_edge_count(other.m_edge_count),
+      m_mode(other.m_mode),
+      m_start(other.m_start),
+      m_end(other.m_end) {
+    index_names();
+}
+
+/**
+ * @brief Asignación por copia. Igual que el constructor de copia, arma de
+ * nuevo la tabla de nombres.
+ * @param other Grafo a copiar.
+ * @return Este grafo.
+ */
+Graph& Graph::operator=(const Graph& other) {
+    if (this != &other) {
+        *this = Graph(other);
+    }
+
+    return *this;
+}
+
+/**
+ * @brief Obtiene el tipo del grafo.
+ * @return GraphMode::undirected si las aristas se recorren en ambos sentidos,
+ * GraphMode::directed en caso contrario.
+ */
+GraphMode Graph::mode() const {
+    return m_mode;
+}
+
+/**
+ * @brief Agrega un nodo al grafo. El nodo es creado sin aristas y se le asigna
+ * el siguiente identificador disponible.
  * @param node Nodo a agregar.
+ * @return Identificador asignado al nodo.
+ * @throws std::invalid_argument si ya existe un nodo con el mismo nombre.
  */
-void Graph::add_node(const GraphNode& node) {
-    m_nodes.push_back(node);
+NodeId Graph::add_node(GraphNode node) {
+    if (m_nodes.size() >= invalid_node) {
+        throw std::length_error("Too many nodes in the graph");
+    }
+
+    const auto id = static_cast<NodeId>(m_nodes.size());
+    if (check_node(node.name)) {
+        throw std::invalid_argument("Node is already in the graph");
+    }
+
+    const auto value = numeric_name(node.name);
+    m_nodes.push_back(std::move(node));
+
+    if (value && *value <= 2 * m_nodes.size() + 1024) {
+        if (*value >= m_numeric_ids.size()) {
+            m_numeric_ids.resize(*value + 1, invalid_node);
+        }
+
+        m_numeric_ids[*value] = id;
+    } else {
+        if (value) {
+            m_min_hashed_numeric = std::min(m_min_hashed_numeric, *value);
+        }
 
-    m_adj_list[node.name] = {};
+        // La clave se toma del nombre ya guardado, que no se mueve más.
+        m_node_ids.emplace(m_nodes.back().name, id);
+    }
+    m_adj_targets.emplace_back();
+    m_adj_weights.emplace_back();
+
+    return id;
 }
 
 /**
@@ -39,7 +245,33 @@ void Graph::add_edge(const std::string& from, const std::string& to,
         throw std::invalid_argument("To node is not in the graph");
     }
 
-    m_adj_list[from].push_back({to, weight});
+    add_edge(node_id(from), node_id(to), weight);
+}
+
+/**
+ * @brief Agrega una arista al grafo. En un grafo no dirigido la arista queda
+ * disponible en ambos sentidos.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @param weight Peso de la arista.
+ */
+void Graph::add_edge(NodeId from, NodeId to, int weight) {
+    if (!check_node(from)) {
+        throw std::invalid_argument("From node is not in the graph");
+    }
+
+    if (!check_node(to)) {
+        throw std::invalid_argument("To node is not in the graph");
+    }
+
+    append_edge(from, to, weight);
+
+    // Una arista no dirigida se guarda en la lista de ambos extremos, para que
+    // neighbors() la entregue desde cualquiera de los dos (ver CsrGraph sobre
+    // por qué no se guarda una sola vez). Un lazo se guarda una sola vez.
+    if (m_mode == GraphMode::undirected && from != to) {
+        append_edge(to, from, weight);
+    }
 }
 
 /**
@@ -48,6 +280,15 @@ void Graph::add_edge(const std::string& from, const std::string& to,
  * @throws std::invalid_argument si el nodo  no está en el grafo.
  */
 void Graph::set_start(const std::string& start) {
+    set_start(node_id(start));
+}
+
+/**
+ * @brief Define el nodo de origen del grafo.
+ * @param start Identificador del nodo de origen.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+void Graph::set_start(NodeId start) {
     if (!check_node(start)) {
         throw std::invalid_argument("Node is not in the graph");
     }
@@ -61,6 +302,15 @@ void Graph::set_start(const std::string& start) {
  * @throws std::invalid_argument si el nodo no está en el grafo.
  */
 void Graph::set_end(const std::string& end) {
+    set_end(node_id(end));
+}
+
+/**
+ * @brief Define el nodo de destino del grafo.
+ * @param end Identificador del nodo de destino.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+void Graph::set_end(NodeId end) {
     if (!check_node(end)) {
         throw std::invalid_argument("Node is not in the graph");
     }
@@ -69,37 +319,47 @@ void Graph::set_end(const std::string& end) {
 }
 
 /**
- * @brief Obtiene el nombre del nodo de origen del grafo.
- * @return Nombre del nodo de origen.
+ * @brief Obtiene el nodo de origen del grafo.
+ * @return Nodo de origen.
+ * @throws std::runtime_error si el nodo de origen no está definido.
+ */
+const GraphNode& Graph::start() const {
+    return m_nodes[start_id()];
+}
+
+/**
+ * @brief Obtiene el nodo de destino del grafo.
+ * @return Nodo de destino.
+ * @throws std::runtime_error si el nodo de destino no está definido.
+ */
+const GraphNode& Graph::end() const {
+    return m_nodes[end_id()];
+}
+
+/**
+ * @brief Obtiene el identificador del nodo de origen del grafo.
+ * @return Identificador del nodo de origen.
  * @throws std::runtime_error si el nodo de origen no está definido.
  */
-GraphNode Graph::start() const {
-    if (m_start.empty()) {
+NodeId Graph::start_id() const {
+    if (m_start == invalid_node) {
         throw std::runtime_error("Start node is not set");
     }
 
-    const auto node_it = std::find_if(
-        std::cbegin(m_nodes), std::cend(m_nodes),
-        [&start = m_start](const auto& node) { return node.name == start; });
-
-    return *node_it;
+    return m_start;
 }
 
 /**
- * @brief Obtiene el nombre del nodo de destino del grafo.
- * @return Nombre del nodo de destino.
+ * @brief Obtiene el identificador del nodo de destino del grafo.
+ * @return Identificador del nodo de destino.
  * @throws std::runtime_error si el nodo de destino no está definido.
  */
-GraphNode Graph::end() const {
-    if (m_end.empty()) {
+NodeId Graph::end_id() const {
+    if (m_end == invalid_node) {
         throw std::runtime_error("End node is not set");
     }
 
-    const auto node_it = std::find_if(
-        std::cbegin(m_nodes), std::cend(m_nodes),
-        [&end = m_end](const auto& node) { return node.name == end; });
-
-    return *node_it;
+    return m_end;
 }
 
 /**
@@ -107,21 +367,41 @@ GraphNode Graph::end() const {
  * @return Número de nodos del grafo.
  */
 std::size_t Graph::vertex_count() const {
-    return m_adj_list.size();
+    return m_nodes.size();
 }
 
 /**
- * @brief Obtiene el número de aristas del grafo.
+ * @brief Obtiene el número de aristas del grafo. En un grafo no dirigido cada
+ * arista cuenta una vez por sentido (los lazos, una sola vez).
  * @return Número de aristas del grafo.
  */
 std::size_t Graph::edge_count() const {
-    std::size_t count = 0;
+    return m_edge_count;
+}
 
-    for (const auto& [_, edges] : m_adj_list) {
-        count += edges.size();
+/**
+ * @brief Obtiene el identificador asignado a un nodo.
+ * @param node Nombre del nodo.
+ * @return Identificador del nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+NodeId Graph::node_id(std::string_view node) const {
+    const auto id = find_node(node);
+    if (!id) {
+        throw std::invalid_argument("Node is not in the graph");
     }
 
-    return count;
+    return *id;
+}
+
+/**
+ * @brief Obtiene el nombre de un nodo a partir de su identificador.
+ * @param node Identificador del nodo.
+ * @return Nombre del nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+const std::string& Graph::node_name(NodeId node) const {
+    return get_node(node).name;
 }
 
 /**
@@ -131,15 +411,17 @@ std::size_t Graph::edge_count() const {
  * @throws std::invalid_argument si el nodo no está en el grafo.
  */
 int Graph::get_heuristic(const std::string& node) const {
-    if (!check_node(node)) {
-        throw std::invalid_argument("Node is not in the graph");
-    }
-
-    const auto node_it =
-        std::find_if(std::cbegin(m_nodes), std::cend(m_nodes),
-                     [&node](const auto& node_) { return node_.name == node; });
+    return get_heuristic(node_id(node));
+}
 
-    return node_it->heuristic;
+/**
+ * @brief Obtiene el valor de la heurística para un nodo.
+ * @param node Identificador del nodo.
+ * @return Valor de la heurística.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+int Graph::get_heuristic(NodeId node) const {
+    return get_node(node).heuristic;
 }
 
 /**
@@ -158,13 +440,31 @@ int Graph::get_cost(const std::string& from, const std::string& to) const {
         throw std::invalid_argument("To node is not in the graph");
     }
 
-    for (const auto& [node, weight] : m_adj_list.at(from)) {
-        if (node == to) {
-            return weight;
-        }
+    return get_cost(node_id(from), node_id(to));
+}
+
+/**
+ * @brief Obtiene el costo de una arista.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return Costo de la arista.
+ * @throws std::invalid_argument si alguno de los nodos no está en el grafo.
+ */
+int Graph::get_cost(NodeId from, NodeId to) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("From node is not in the graph");
     }
 
-    throw std::runtime_error("Nodes are not connected");
+    if (!check_node(to)) {
+        throw std::invalid_argument("To node is not in the graph");
+    }
+
+    const auto position = find_edge(from, to);
+    if (!position) {
+        throw std::runtime_error("Nodes are not connected");
+    }
+
+    return m_adj_weights[from][*position];
 }
 
 /**
@@ -173,16 +473,22 @@ int Graph::get_cost(const std::string& from, const std::string& to) const {
  * @return Nodo.
  * @throws std::invalid_argument si el nodo no está en el grafo.
  */
-GraphNode Graph::get_node(const std::string& node) const {
+const GraphNode& Graph::get_node(const std::string& node) const {
+    return get_node(node_id(node));
+}
+
+/**
+ * Busca un nodo en el grafo y lo retorna.
+ * @param node Identificador del nodo.
+ * @return Nodo.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+const GraphNode& Graph::get_node(NodeId node) const {
     if (!check_node(node)) {
         throw std::invalid_argument("Node is not in the graph");
     }
 
-    const auto node_it =
-        std::find_if(std::cbegin(m_nodes), std::cend(m_nodes),
-                     [&node](const auto& node_) { return node_.name == node; });
-
-    return *node_it;
+    return m_nodes[node];
 }
 
 /**
@@ -192,8 +498,8 @@ GraphNode Graph::get_node(const std::string& node) const {
 std::set<std::string> Graph::get_nodes() const {
     std::set<std::string> ret;
 
-    for (const auto& [node, _] : m_adj_list) {
-        ret.insert(node);
+    for (const auto& node : m_nodes) {
+        ret.insert(node.name);
     }
 
     return ret;
@@ -206,9 +512,10 @@ std::set<std::string> Graph::get_nodes() const {
 std::set<std::tuple<std::string, std::string, int>> Graph::get_edges() const {
     std::set<std::tuple<std::string, std::string, int>> ret;
 
-    for (const auto& [node, edges] : m_adj_list) {
-        for (const auto& [to, weight] : edges) {
-            ret.insert(std::make_tuple(node, to, weight));
+    for (NodeId from = 0; from < m_nodes.size(); ++from) {
+        for (const auto& [to, weight] : neighbors(from)) {
+            ret.insert(
+                std::make_tuple(m_nodes[from].name, m_nodes[to].name, weight));
         }
     }
 
@@ -223,18 +530,41 @@ std::set<std::tuple<std::string, std::string, int>> Graph::get_edges() const {
  */
 std::set<std::pair<std::string, int>> Graph::get_neighbors(
     const std::string& from) const {
-    if (!check_node(from)) {
-        throw std::invalid_argument("Node is not in the graph");
-    }
-
     std::set<std::pair<std::string, int>> nodes;
-    for (const auto& [node, weight] : m_adj_list.at(from)) {
-        nodes.insert({node, weight});
+    for (const auto& [node, weight] : neighbors(node_id(from))) {
+        nodes.insert({m_nodes[node].name, weight});
     }
 
     return nodes;
 }
 
+/**
+ * @brief Obtiene los nodos adyacentes a un nodo.
+ * @param from Identificador del nodo.
+ * @return Conjunto de identificadores de los nodos adyacentes.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+std::set<std::pair<NodeId, int>> Graph::get_neighbors(NodeId from) const {
+    const auto range = neighbors(from);
+
+    return {std::cbegin(range), std::cend(range)};
+}
+
+/**
+ * @brief Obtiene los nodos adyacentes a un nodo, sin copiarlos.
+ * @param from Identificador del nodo.
+ * @return Rango de pares (vecino, peso) sobre la lista de adyacencia.
+ * @throws std::invalid_argument si el nodo no está en el grafo.
+ */
+NeighborRange Graph::neighbors(NodeId from) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("Node is not in the graph");
+    }
+
+    return {m_adj_targets[from].data(), m_adj_weights[from].data(),
+            m_adj_targets[from].size()};
+}
+
 /**
  * @brief Revisa si dos nodos están conectados.
  * @param from Nombre del nodo de origen.
@@ -252,11 +582,24 @@ bool Graph::are_connected(const std::string& from,
         throw std::invalid_argument("To node is not in the graph");
     }
 
-    for (const auto& [node, weight] : m_adj_list.at(from)) {
-        if (node == to) {
-            return true;
-        }
+    return are_connected(node_id(from), node_id(to));
+}
+
+/**
+ * @brief Revisa si dos nodos están conectados.
+ * @param from Identificador del nodo de origen.
+ * @param to Identificador del nodo de destino.
+ * @return true si los nodos están conectados, false en caso contrario.
+ * @throws std::invalid_argument si alguno de los nodos no está en el grafo.
+ */
+bool Graph::are_connected(NodeId from, NodeId to) const {
+    if (!check_node(from)) {
+        throw std::invalid_argument("From node is not in the graph");
+    }
+
+    if (!check_node(to)) {
+        throw std::invalid_argument("To node is not in the graph");
     }
 
-    return false;
+    return find_edge(from, to).has_value();
 }
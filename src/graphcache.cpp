@@ -0,0 +1,163 @@
+#include "graphcache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "mappedfile.h"
+
+namespace {
+
+/**
+ * @brief Obtiene el tamaño y la fecha de modificación (en nanosegundos) de
+ * un archivo.
+ * @throws std::runtime_error si no se puede consultar el archivo.
+ */
+SnapshotSource stat_source(const std::string& path) {
+    struct stat st;
+    if (::stat(path.c_str(), &st) < 0) {
+        throw std::runtime_error("Cannot stat " + path + ": " +
+                                 std::strerror(errno));
+    }
+
+    SnapshotSource source;
+    source.size = static_cast<std::uint64_t>(st.st_size);
+    source.mtime = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000 +
+                   st.st_mtim.tv_nsec;
+
+    return source;
+}
+
+/**
+ * @brief Hash FNV-1a del contenido de un archivo, sobre palabras de 64 bits
+ * como el checksum de los snapshots. La última palabra incompleta se rellena
+ * con ceros.
+ */
+std::uint64_t hash_file(const std::string& path) {
+    const MappedFile file(path);
+
+    std::uint64_t hash = 0xcbf29ce484222325;
+    const auto mix = [&hash](std::uint64_t word) {
+        hash = (hash ^ word) * 0x100000001b3;
+    };
+
+    const auto size = file.size();
+    const auto whole = size - size % sizeof(std::uint64_t);
+    for (std::size_t i = 0; i < whole; i += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, file.data() + i, sizeof(word));
+        mix(word);
+    }
+
+    if (whole < size) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, file.data() + whole, size - whole);
+        mix(word);
+    }
+
+    return hash;
+}
+
+}  // namespace
+
+/**
+ * @brief Constructor. Registra el tamaño y la fecha de modificación del
+ * archivo de texto; el hash se calcula solo cuando hace falta.
+ * @param path Ruta del archivo de texto.
+ * @throws std::runtime_error si no se puede consultar el archivo.
+ */
+GraphCache::GraphCache(const std::string& path)
+    : m_path(path), m_cache_path(path + ".bin"), m_source(stat_source(path)) {}
+
+/**
+ * @brief Calcula el hash del archivo de texto, si no se ha calculado.
+ */
+void GraphCache::hash_source() {
+    if (!m_hashed) {
+        m_source.hash = hash_file(m_path);
+        m_hashed = true;
+    }
+}
+
+/**
+ * @brief Obtiene la ruta del archivo de caché.
+ */
+const std::string& GraphCache::cache_path() const {
+    return m_cache_path;
+}
+
+/**
+ * @brief Abre la caché si corresponde al archivo de texto actual. El tamaño
+ * y la fecha se comparan primero, y el hash del contenido solo si ambos
+ * coinciden.
+ * @param mode Tipo de grafo con que se quiere leer el archivo.
+ * @return El grafo guardado en la caché, o std::nullopt si no hay caché, está
+ * desactualizada o no se puede abrir.
+ */
+std::optional<CsrGraph> GraphCache::load(GraphMode mode) {
+    const auto info = read_snapshot_info(m_cache_path);
+    if (!info || info->mode != mode || info->source.size != m_source.size ||
+        info->source.mtime != m_source.mtime) {
+        return std::nullopt;
+    }
+
+    hash_source();
+    if (info->source.hash != m_source.hash) {
+        return std::nullopt;
+    }
+
+    // La caché la escribe este mismo programa, así que no se verifica su
+    // contenido; basta con que su cabecera y su tamaño sean correctos.
+    try {
+        return read_snapshot<int>(m_cache_path, false);
+    } catch (const std::runtime_error&) {
+        // Una caché truncada se trata igual que una desactualizada.
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Guarda el grafo como caché del archivo de texto. El snapshot se
+ * escribe en un archivo temporal que luego se renombra, de modo que quien
+ * lea la caché al mismo tiempo ve la versión anterior o la nueva completa.
+ * La caché es solo una optimización, así que un error al escribirla no se
+ * propaga.
+ * @param graph Grafo leído desde el archivo de texto.
+ * @return true si la caché se guardó.
+ */
+bool GraphCache::store(const CsrGraph& graph) {
+    try {
+        hash_source();
+
+        // Si el texto cambió mientras se leía, el grafo puede no
+        // corresponder a lo que se registró, así que no se guarda.
+        const auto current = stat_source(m_path);
+        if (current.size != m_source.size ||
+            current.mtime != m_source.mtime) {
+            return false;
+        }
+
+        const auto temp_path =
+            m_cache_path + ".tmp" + std::to_string(::getpid());
+        try {
+            write_snapshot(graph, temp_path, m_source);
+        } catch (const std::runtime_error&) {
+            std::remove(temp_path.c_str());
+            throw;
+        }
+
+        if (std::rename(temp_path.c_str(), m_cache_path.c_str()) != 0) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+
+    return true;
+}
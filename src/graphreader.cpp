@@ -1,84 +1,774 @@
 #include "graphreader.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
-#include <regex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "decompress.h"
+#include "mappedfile.h"
+
+namespace {
+
+/*
+ * El formato se reconoce con un analizador escrito a mano en lugar de
+ * expresiones regulares. Cada línea se recorre como un std::string_view sobre
+ * el búfer de lectura, sin copiarla, y los números se convierten con
+ * std::from_chars. Los reconocedores de registros aceptan lo mismo que estas
+ * expresiones regulares, buscadas en cualquier posición de la línea:
+ *
+ *   nodo     ([A-Za-z0-9_]+)\s+([0-9]+)
+ *   arista   ([A-Za-z0-9_]+),\s*([A-Za-z0-9_]+),\s*([0-9]+)
+ */
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Caracteres que pueden formar el nombre de un nodo.
+bool is_name_char(char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || is_digit(c) ||
+           c == '_';
+}
+
+// Mismos caracteres que \s en las expresiones regulares ECMAScript.
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' ||
+           c == '\r';
+}
 
 /**
- * @brief Lee las líneas de un archivo a partir de un std::istream.
- * @param infile std::istream del archivo.
+ * @brief Número sin signo dentro de una línea, junto con su columna (desde 0).
  */
-void GraphReader::read_file(std::istream &infile) {
-    std::string line;
+struct Number {
+    std::string_view digits;
+    std::size_t column;
+};
+
+struct NodeRecord {
+    std::string_view name;
+    std::size_t name_column;
+    Number heuristic;
+};
+
+struct EdgeRecord {
+    std::string_view from;
+    std::size_t from_column;
+    std::string_view to;
+    std::size_t to_column;
+    Number weight;
+};
 
-    while (std::getline(infile, line)) {
-        m_lines.push_back(line);
+/**
+ * @brief Avanza sobre los espacios que empiezan en `pos`.
+ */
+std::size_t skip_spaces(std::string_view line, std::size_t pos) {
+    while (pos < line.size() && is_space(line[pos])) {
+        ++pos;
     }
+
+    return pos;
 }
 
 /**
- * @brief Crea el grafo a partir de las líneas leídas.
+ * @brief Reconoce un número que empieza exactamente en `pos`.
  */
-void GraphReader::make_graph() {
-    std::size_t cur_line = 2;
+std::optional<Number> match_number(std::string_view line, std::size_t pos) {
+    auto end = pos;
+    while (end < line.size() && is_digit(line[end])) {
+        ++end;
+    }
 
-    // Leer los nodos y sus heurísticas
-    std::regex node_regex("([A-Za-z])\\s+([0-9]+)");
-    while (true) {
-        std::smatch match;
+    if (end == pos) {
+        return std::nullopt;
+    }
 
-        if (!std::regex_search(m_lines[cur_line], match, node_regex)) {
-            break;
+    return Number{line.substr(pos, end - pos), pos};
+}
+
+/**
+ * @brief Avanza hasta el final del nombre que empieza en `pos`.
+ */
+std::size_t skip_name(std::string_view line, std::size_t pos) {
+    while (pos < line.size() && is_name_char(line[pos])) {
+        ++pos;
+    }
+
+    return pos;
+}
+
+/*
+ * Los nombres solo se prueban desde su primer carácter: como la repetición es
+ * voraz, un intento que empieza dentro de un nombre termina en el mismo lugar
+ * que el que empieza al comienzo, así que falla igual.
+ */
+
+/**
+ * @brief Busca un registro de nodo (`<nombre> <heurística>`) en la línea.
+ */
+std::optional<NodeRecord> match_node(std::string_view line) {
+    for (std::size_t i = 0; i < line.size();) {
+        if (!is_name_char(line[i])) {
+            ++i;
+            continue;
         }
 
-        m_graph.add_node({match[1], std::stoi(match[2])});
+        const auto end = skip_name(line, i);
+        if (end < line.size() && is_space(line[end])) {
+            if (const auto heuristic =
+                    match_number(line, skip_spaces(line, end))) {
+                return NodeRecord{line.substr(i, end - i), i, *heuristic};
+            }
+        }
 
-        cur_line++;
+        i = end;
     }
 
-    // Leer las aristas y sus pesos. Se asume que el grafo es no dirigido.
-    std::regex edge_regex("([A-Za-z]),\\s*([A-Za-z]),\\s*([0-9]+)");
-    while (cur_line < m_lines.size()) {
-        std::smatch match;
+    return std::nullopt;
+}
 
-        if (!std::regex_search(m_lines[cur_line], match, edge_regex)) {
-            break;
+/**
+ * @brief Busca un registro de arista (`<origen>, <destino>, <costo>`) en la
+ * línea.
+ */
+std::optional<EdgeRecord> match_edge(std::string_view line) {
+    for (std::size_t i = 0; i < line.size();) {
+        if (!is_name_char(line[i])) {
+            ++i;
+            continue;
+        }
+
+        const auto from_end = skip_name(line, i);
+        if (from_end >= line.size() || line[from_end] != ',') {
+            i = from_end;
+            continue;
+        }
+
+        const auto to = skip_spaces(line, from_end + 1);
+        const auto to_end = skip_name(line, to);
+        if (to_end > to && to_end < line.size() && line[to_end] == ',') {
+            if (const auto weight =
+                    match_number(line, skip_spaces(line, to_end + 1))) {
+                return EdgeRecord{line.substr(i, from_end - i), i,
+                                  line.substr(to, to_end - to), to, *weight};
+            }
+        }
+
+        i = from_end;
+    }
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Construye un error que indica el archivo, la línea y la columna
+ * (ambas desde 1) en que se produjo.
+ */
+std::runtime_error parse_error(const std::string& source, std::size_t line,
+                               std::size_t column, const std::string& what) {
+    return std::runtime_error(source + ":" + std::to_string(line) + ":" +
+                              std::to_string(column) + ": " + what);
+}
+
+/**
+ * @brief Lee las líneas de un std::istream a medida que se necesitan, a
+ * través de un búfer de tamaño acotado: nunca se guarda más texto que el de
+ * un bloque de lectura o, si es más larga, el de la línea actual. Al igual
+ * que std::getline, el salto de línea no forma parte de la línea y un salto
+ * final no agrega una línea vacía.
+ */
+class LineReader {
+private:
+    static constexpr std::size_t block_size = 1 << 16;
+
+    std::istream& m_in;
+    std::vector<char> m_buffer;
+    std::size_t m_begin = 0;
+    std::size_t m_end = 0;
+    std::size_t m_number = 0;
+    bool m_eof = false;
+
+    /**
+     * @brief Descarta las líneas ya entregadas y lee otro bloque a
+     * continuación del texto pendiente, agrandando el búfer si el texto
+     * pendiente (una línea incompleta) lo llena.
+     */
+    void refill() {
+        std::copy(std::cbegin(m_buffer) + m_begin,
+                  std::cbegin(m_buffer) + m_end, std::begin(m_buffer));
+        m_end -= m_begin;
+        m_begin = 0;
+
+        if (m_buffer.size() - m_end < block_size) {
+            m_buffer.resize(m_end + block_size);
+        }
+
+        m_in.read(m_buffer.data() + m_end, m_buffer.size() - m_end);
+        m_end += m_in.gcount();
+        m_eof = !m_in;
+    }
+
+public:
+    explicit LineReader(std::istream& in) : m_in(in), m_buffer(block_size) {}
+
+    /**
+     * @brief Obtiene la siguiente línea, o std::nullopt al final del texto.
+     * La vista es válida hasta la siguiente llamada.
+     */
+    std::optional<std::string_view> next() {
+        auto scanned = m_begin;
+
+        while (true) {
+            const auto* data = m_buffer.data();
+            const auto* newline = std::find(data + scanned, data + m_end, '\n');
+
+            if (newline != data + m_end) {
+                const std::string_view line(data + m_begin,
+                                            newline - (data + m_begin));
+                m_begin = newline - data + 1;
+                m_number++;
+                return line;
+            }
+
+            if (m_eof) {
+                if (m_begin == m_end) {
+                    return std::nullopt;
+                }
+
+                const std::string_view line(data + m_begin, m_end - m_begin);
+                m_begin = m_end;
+                m_number++;
+                return line;
+            }
+
+            // No hay un salto de línea en lo que queda del búfer: se lee más
+            // texto sin volver a revisar lo ya revisado.
+            scanned = m_end - m_begin;
+            refill();
+            scanned += m_begin;
+        }
+    }
+
+    /**
+     * @brief Número (desde 1) de la última línea entregada por next().
+     */
+    std::size_t number() const { return m_number; }
+};
+
+/**
+ * @brief Recorre las líneas de un texto que ya está en memoria, con las
+ * mismas reglas que LineReader.
+ */
+class TextLines {
+private:
+    std::string_view m_text;
+    std::size_t m_pos = 0;
+    std::size_t m_number = 0;
+
+public:
+    explicit TextLines(std::string_view text) : m_text(text) {}
+
+    std::optional<std::string_view> next() {
+        if (m_pos >= m_text.size()) {
+            return std::nullopt;
+        }
+
+        auto end = m_text.find('\n', m_pos);
+        if (end == std::string_view::npos) {
+            end = m_text.size();
+        }
+
+        const auto line = m_text.substr(m_pos, end - m_pos);
+        m_pos = end + 1;
+        m_number++;
+
+        return line;
+    }
+
+    std::size_t number() const { return m_number; }
+};
+
+/**
+ * @brief Interpreta los registros del formato de texto y agrega los nodos a
+ * un grafo. Lo comparten el lector secuencial y el paralelo, que obtienen las
+ * líneas de distinta forma pero deben interpretarlas igual.
+ */
+class GraphParser {
+public:
+    struct Edge {
+        NodeId from;
+        NodeId to;
+        int weight;
+    };
+
+private:
+    const std::string& m_source;
+    Graph& m_graph;
+
+    std::string m_init_line;
+    std::string m_goal_line;
+
+    int parse_int(const Number& number, std::size_t line,
+                  const char* what) const {
+        int value = 0;
+        const auto* first = number.digits.data();
+        const auto* last = first + number.digits.size();
+        if (std::from_chars(first, last, value).ec != std::errc()) {
+            throw parse_error(m_source, line, number.column + 1,
+                              std::string(what) + " is out of range");
+        }
+
+        return value;
+    }
+
+    NodeId lookup(std::string_view name, std::size_t line,
+                  std::size_t column) const {
+        try {
+            return m_graph.node_id(name);
+        } catch (const std::invalid_argument&) {
+            throw parse_error(m_source, line, column + 1,
+                              "node '" + std::string(name) +
+                                  "' is not defined");
+        }
+    }
+
+    void define(const NodeRecord& node, std::size_t line) {
+        try {
+            m_graph.add_node(
+                {std::string(node.name),
+                 parse_int(node.heuristic, line, "heuristic")});
+        } catch (const std::invalid_argument&) {
+            throw parse_error(m_source, line, node.name_column + 1,
+                              "node '" + std::string(node.name) +
+                                  "' is already defined");
+        }
+    }
+
+    /**
+     * @brief Define el origen o el destino. El nombre es todo lo que sigue al
+     * prefijo de 6 caracteres ("Init: " o "Goal: ").
+     */
+    void set_terminal(std::string_view text, std::size_t line, bool start) {
+        if (text.size() < 6) {
+            throw parse_error(m_source, line, text.size() + 1,
+                              start ? "expected 'Init: <node>'"
+                                    : "expected 'Goal: <node>'");
+        }
+
+        try {
+            const auto id = m_graph.node_id(text.substr(6));
+            if (start) {
+                m_graph.set_start(id);
+            } else {
+                m_graph.set_end(id);
+            }
+        } catch (const std::invalid_argument&) {
+            throw parse_error(m_source, line, 7,
+                              "node '" + std::string(text.substr(6)) +
+                                  "' is not defined");
         }
+    }
+
+public:
+    GraphParser(const std::string& source, Graph& graph)
+        : m_source(source), m_graph(graph) {}
 
-        m_graph.add_edge(match[1], match[2], std::stoi(match[3]));
-        // m_graph.add_edge(match[2], match[1], std::stoi(match[3]));
+    /**
+     * @brief Lee las líneas de origen y destino y la sección de nodos.
+     * @return La primera línea después de los nodos, o std::nullopt si el
+     * texto termina antes.
+     */
+    template <typename Lines>
+    std::optional<std::string_view> read_nodes(Lines& lines) {
+        // Las dos primeras líneas se guardan, porque el origen y el destino
+        // solo se pueden resolver cuando ya se leyeron los nodos.
+        for (auto* header : {&m_init_line, &m_goal_line}) {
+            const auto line = lines.next();
+            if (!line) {
+                throw parse_error(m_source, lines.number() + 1, 1,
+                                  "expected 'Init:' and 'Goal:' lines");
+            }
+
+            header->assign(*line);
+        }
+
+        auto line = lines.next();
+        for (; line; line = lines.next()) {
+            const auto node = match_node(*line);
+            if (!node) {
+                break;
+            }
+
+            define(*node, lines.number());
+        }
 
-        cur_line++;
+        return line;
     }
 
-    // Definir el nodo de origen y el nodo de destino
-    m_graph.set_start(m_lines[0].substr(6));
-    m_graph.set_end(m_lines[1].substr(6));
+    /**
+     * @brief Interpreta una línea de la sección de aristas. No modifica el
+     * grafo, así que se puede llamar desde varios hilos a la vez.
+     * @return La arista, o std::nullopt si la línea no es una arista.
+     */
+    std::optional<Edge> parse_edge(std::string_view line,
+                                   std::size_t number) const {
+        const auto edge = match_edge(line);
+        if (!edge) {
+            return std::nullopt;
+        }
+
+        const auto from = lookup(edge->from, number, edge->from_column);
+        const auto to = lookup(edge->to, number, edge->to_column);
+
+        return Edge{from, to, parse_int(edge->weight, number, "weight")};
+    }
+
+    /**
+     * @brief Resuelve el origen y el destino con los nodos ya leídos.
+     */
+    void finish() {
+        set_terminal(m_init_line, 1, true);
+        set_terminal(m_goal_line, 2, false);
+    }
+};
+
+/**
+ * @brief Ejecuta `task(i)` para cada `i` en `[0, count)`, cada uno en su
+ * propio hilo. El último se ejecuta en el hilo que llama.
+ */
+template <typename Task>
+void parallel_for(std::size_t count, const Task& task) {
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+
+    for (std::size_t i = 0; i + 1 < count; ++i) {
+        threads.emplace_back([&task, i] { task(i); });
+    }
+
+    if (count > 0) {
+        task(count - 1);
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
 }
 
 /**
- * @brief Constructor por defecto. Lee el grafo desde la entrada estándar.
+ * @brief Trozo de la sección de aristas que procesa un hilo.
  */
-GraphReader::GraphReader() {
-    read_file(std::cin);
-    make_graph();
+struct EdgeChunk {
+    std::string_view text;
+
+    // Aristas del trozo, en el orden del archivo, repartidas según el tramo
+    // de nodos al que pertenece su origen. En un grafo no dirigido cada
+    // arista se agrega también invertida, en el tramo de su destino.
+    std::vector<std::vector<GraphParser::Edge>> edges;
+
+    // Número de líneas de aristas que se leyeron del trozo.
+    std::size_t count = 0;
+
+    // Si el trozo contiene el fin de la sección de aristas (una línea que no
+    // es arista, o una con un error), `stop` es esa línea.
+    std::optional<std::string_view> stop;
+    bool failed = false;
+};
+
+}  // namespace
+
+/**
+ * @brief Crea el grafo a medida que se lee el texto. Cada registro se
+ * procesa apenas se lee y el texto no se guarda; la lectura termina en la
+ * primera línea que no es una arista.
+ * @param infile std::istream del archivo.
+ * @param mode Indica si las aristas tienen dirección.
+ * @throws std::runtime_error si el texto no tiene el formato esperado, con la
+ * línea y columna del error.
+ */
+void GraphReader::make_graph(std::istream &infile, GraphMode mode) {
+    m_graph = std::make_shared<Graph>(mode);
+
+    GraphParser parser(m_source, *m_graph);
+    LineReader lines(infile);
+
+    // Leer las aristas y sus pesos. En un grafo no dirigido, Graph se encarga
+    // de que cada arista se pueda recorrer en ambos sentidos.
+    for (auto line = parser.read_nodes(lines); line; line = lines.next()) {
+        const auto edge = parser.parse_edge(*line, lines.number());
+        if (!edge) {
+            break;
+        }
+
+        m_graph->add_edge(edge->from, edge->to, edge->weight);
+    }
+
+    parser.finish();
 }
 
 /**
- * @brief Constructor. Lee el grafo desde un archivo.
+ * @brief Constructor. Lee el grafo desde la entrada estándar.
+ * @param mode Indica si las aristas tienen dirección.
+ */
+GraphReader::GraphReader(GraphMode mode) : m_source("<stdin>") {
+    make_graph(std::cin, mode);
+}
+
+/**
+ * @brief Constructor. Lee el grafo desde un archivo. Los archivos comprimidos
+ * con gzip o zstd se reconocen por su firma y se descomprimen en otro hilo a
+ * medida que se leen, sin pasar por un archivo temporal.
  * @param path Ruta del archivo.
+ * @param mode Indica si las aristas tienen dirección.
+ * @throws std::runtime_error si no se puede abrir el archivo, está dañado o
+ * no tiene el formato esperado.
  */
-GraphReader::GraphReader(const std::string &path) {
-    std::ifstream infile(path);
+GraphReader::GraphReader(const std::string &path, GraphMode mode)
+    : m_source(path) {
+    if (const auto kind = detect_compression(path);
+        kind != Compression::none) {
+        DecompressStreambuf buffer(path, kind);
+        std::istream infile(&buffer);
+
+        // Así los errores de descompresión llegan como excepción en lugar de
+        // parecer el final del archivo.
+        infile.exceptions(std::ios::badbit);
+
+        make_graph(infile, mode);
+        return;
+    }
+
+    std::ifstream infile(path, std::ios::binary);
+    if (!infile) {
+        throw std::runtime_error("Cannot open " + path);
+    }
 
-    read_file(infile);
-    make_graph();
+    make_graph(infile, mode);
 }
 
 /**
- * @brief Obtiene el grafo leído.
+ * @brief Obtiene el grafo leído. El grafo no se copia: todos los que lo
+ * pidan comparten la misma instancia, que no se puede modificar.
  * @return Grafo leído.
  */
-Graph GraphReader::get_graph() const {
+std::shared_ptr<const Graph> GraphReader::get_graph() const {
     return m_graph;
 }
+
+/**
+ * @brief Lee un grafo en formato de texto usando varios hilos, y lo entrega
+ * ya congelado. El archivo se mapea en memoria; los nodos se leen en forma
+ * secuencial y la sección de aristas se divide en trozos que terminan en un
+ * salto de línea, uno por hilo. Los nodos se dividen en tramos contiguos,
+ * también uno por hilo. Cada hilo interpreta su trozo y deja cada arista en
+ * la lista del tramo de su origen; después, cada hilo arma las filas de su
+ * tramo con un ordenamiento por conteo sobre las listas de ese tramo. Así
+ * los contadores ocupan un arreglo por nodo en total, y no uno por trozo.
+ *
+ * Los trozos se unen en el orden del archivo, de modo que el resultado, y
+ * también el primer error que se informa, son idénticos a los de leer el
+ * archivo con GraphReader y congelarlo. Un archivo comprimido no se puede
+ * mapear, así que se lee con GraphReader.
+ *
+ * @param path Ruta del archivo.
+ * @param mode Indica si las aristas tienen dirección.
+ * @param threads Número de hilos.
+ * @return Grafo leído.
+ * @throws std::runtime_error si no se puede abrir el archivo o no tiene el
+ * formato esperado.
+ */
+CsrGraph read_graph_parallel(const std::string &path, GraphMode mode,
+                             unsigned threads) {
+    if (detect_compression(path) != Compression::none) {
+        return CsrGraph(*GraphReader(path, mode).get_graph());
+    }
+
+    const MappedFile file(path);
+    const std::string_view text(file.data(), file.size());
+
+    Graph nodes(mode);
+    GraphParser parser(path, nodes);
+    TextLines lines(text);
+
+    const auto first_edge = parser.read_nodes(lines);
+    const auto first_edge_number = lines.number();
+
+    const auto node_count = nodes.vertex_count();
+    const bool undirected = mode == GraphMode::undirected;
+
+    // Tramos de nodos: el hilo `w` arma las filas de
+    // `[w * range_size, (w + 1) * range_size)`.
+    const std::size_t workers = std::max(threads, 1u);
+    const auto range_size = std::max<std::size_t>(
+        (node_count + workers - 1) / workers, 1);
+
+    // Dividir la sección de aristas en trozos de tamaño parecido, cada uno
+    // terminado en un salto de línea.
+    std::vector<EdgeChunk> chunks;
+    if (first_edge) {
+        const auto section = text.substr(first_edge->data() - text.data());
+        const auto target = section.size() / std::max(threads, 1u) + 1;
+
+        for (std::size_t begin = 0; begin < section.size();) {
+            auto end = section.find('\n', std::min(begin + target,
+                                                    section.size() - 1));
+            end = end == std::string_view::npos ? section.size() : end + 1;
+
+            chunks.push_back({section.substr(begin, end - begin),
+                              std::vector<std::vector<GraphParser::Edge>>(
+                                  workers),
+                              0,
+                              {}});
+            begin = end;
+        }
+    }
+
+    parallel_for(chunks.size(), [&](std::size_t i) {
+        auto& chunk = chunks[i];
+        TextLines chunk_lines(chunk.text);
+
+        for (auto line = chunk_lines.next(); line; line = chunk_lines.next()) {
+            try {
+                const auto edge = parser.parse_edge(*line, 0);
+                if (!edge) {
+                    chunk.stop = line;
+                    break;
+                }
+
+                chunk.edges[edge->from / range_size].push_back(*edge);
+                if (undirected && edge->from != edge->to) {
+                    chunk.edges[edge->to / range_size].push_back(
+                        {edge->to, edge->from, edge->weight});
+                }
+                chunk.count++;
+            } catch (const std::exception &) {
+                chunk.stop = line;
+                chunk.failed = true;
+                break;
+            }
+        }
+    });
+
+    // La sección termina en el primer trozo que se detuvo; los trozos
+    // siguientes se descartan. Si se detuvo por un error, la línea se vuelve
+    // a interpretar con su número real para informar el mismo error que la
+    // lectura secuencial.
+    auto line_number = first_edge_number;
+    std::size_t used = 0;
+    while (used < chunks.size()) {
+        const auto& chunk = chunks[used++];
+        line_number += chunk.count;
+
+        if (chunk.failed) {
+            parser.parse_edge(*chunk.stop, line_number);
+        }
+
+        if (chunk.stop) {
+            break;
+        }
+    }
+    chunks.resize(used);
+
+    parser.finish();
+
+    // Cada hilo cuenta las aristas de los orígenes de su tramo. Los tramos
+    // son disjuntos, así que cada uno escribe en su parte de `offsets`.
+    CsrGraph::Arrays arrays;
+    arrays.offsets.assign(node_count + 1, 0);
+    std::vector<std::uint64_t> range_edges(workers + 1, 0);
+    parallel_for(workers, [&](std::size_t w) {
+        for (const auto& chunk : chunks) {
+            for (const auto& edge : chunk.edges[w]) {
+                arrays.offsets[edge.from + 1]++;
+            }
+
+            range_edges[w + 1] += chunk.edges[w].size();
+        }
+    });
+
+    std::partial_sum(std::cbegin(range_edges), std::cend(range_edges),
+                     std::begin(range_edges));
+
+    const auto edge_count = range_edges[workers];
+    arrays.targets.resize(edge_count);
+    arrays.weights.resize(edge_count);
+
+    // Cada hilo convierte los conteos de su tramo en inicios de fila, a
+    // partir de la primera arista del tramo, y reparte las aristas de sus
+    // listas recorriendo los trozos en orden: las aristas de un origen
+    // quedan en el orden del archivo, igual que al agregarlas una a una.
+    // Después ordena cada fila por destino; el orden es estable, como en
+    // CsrGraph.
+    parallel_for(workers, [&](std::size_t w) {
+        const auto first_node = std::min(w * range_size, node_count);
+        const auto last_node = std::min(first_node + range_size, node_count);
+
+        std::vector<std::uint64_t> next(last_node - first_node);
+        auto position = range_edges[w];
+        for (auto node = first_node; node < last_node; ++node) {
+            next[node - first_node] = position;
+            position += arrays.offsets[node + 1];
+            arrays.offsets[node + 1] = position;
+        }
+
+        for (auto& chunk : chunks) {
+            for (const auto& edge : chunk.edges[w]) {
+                const auto i = next[edge.from - first_node]++;
+                arrays.targets[i] = edge.to;
+                arrays.weights[i] = edge.weight;
+            }
+
+            chunk.edges[w] = {};
+        }
+
+        // Al terminar el reparto, `next` marca el final de cada fila.
+        std::vector<std::pair<NodeId, int>> row;
+        auto first = range_edges[w];
+        for (auto node = first_node; node < last_node; ++node) {
+            const auto last = next[node - first_node];
+
+            row.clear();
+            for (auto i = first; i < last; ++i) {
+                row.emplace_back(arrays.targets[i], arrays.weights[i]);
+            }
+
+            std::stable_sort(std::begin(row), std::end(row),
+                             [](const auto& lhs, const auto& rhs) {
+                                 return lhs.first < rhs.first;
+                             });
+
+            for (auto i = first; i < last; ++i) {
+                arrays.targets[i] = row[i - first].first;
+                arrays.weights[i] = row[i - first].second;
+            }
+
+            first = last;
+        }
+    });
+
+    chunks.clear();
+
+    arrays.heuristics.reserve(node_count);
+    arrays.name_offsets.reserve(node_count + 1);
+    arrays.name_offsets.push_back(0);
+    for (NodeId node = 0; node < node_count; ++node) {
+        const auto& info = nodes.get_node(node);
+
+        arrays.heuristics.push_back(info.heuristic);
+        arrays.names.insert(std::end(arrays.names), std::cbegin(info.name),
+                            std::cend(info.name));
+        arrays.name_offsets.push_back(arrays.names.size());
+    }
+
+    arrays.start = nodes.start_id();
+    arrays.end = nodes.end_id();
+    arrays.mode = mode;
+
+    return CsrGraph(std::move(arrays));
+}
@@ -1,89 +1,554 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
+#include <charconv>
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <vector>
 
+#include "compressedgraph.h"
+#include "csrgraph.h"
+#include "dimacsreader.h"
+#include "graphcache.h"
 #include "graph.h"
 #include "graphreader.h"
+#include "heuristics.h"
+#include "reachability.h"
+#include "reorder.h"
+#include "snapshot.h"
 #include "solvers/a-star.h"
 #include "solvers/dfs.h"
 #include "solvers/greedy.h"
 #include "solvers/solver.h"
 #include "solvers/ucs.h"
 
+/**
+ * @brief Carga el grafo de entrada. Los snapshots binarios se reconocen por
+ * su firma y se abren directamente, verificando su contenido solo con
+ * --verificar; cualquier otro archivo se lee en el formato indicado por las
+ * opciones. Los archivos de texto se abren desde su caché binaria si está al
+ * día, y la caché se regenera si no lo está.
+ * @param path Ruta del archivo.
+ * @param mode Tipo de grafo para los archivos de texto y DIMACS. Un snapshot
+ * conserva el tipo con que se guardó.
+ * @param threads Número de hilos con que se leen los archivos de texto.
+ * @param options Opciones de la línea de comandos.
+ * @return Grafo congelado, compartido entre quienes lo usen.
+ */
+std::shared_ptr<const CsrGraph> load_graph(
+    const std::string& path, GraphMode mode, unsigned threads,
+    const std::map<std::string, std::string>& options) {
+    if (is_snapshot(path)) {
+        return std::make_shared<const CsrGraph>(
+            read_snapshot<int>(path, options.count("verificar") != 0));
+    }
+
+    if (const auto it = options.find("formato");
+        it != options.end() && it->second == "dimacs") {
+        const auto option = [&options](const std::string& name) {
+            const auto it = options.find(name);
+            return it != options.end() ? it->second : std::string();
+        };
+
+        if (option("origen").empty() || option("destino").empty()) {
+            throw std::invalid_argument(
+                "El formato dimacs requiere --origen y --destino");
+        }
+
+        return std::make_shared<const CsrGraph>(
+            read_dimacs(path, option("coordenadas"), option("origen"),
+                        option("destino"), mode));
+    }
+
+    std::optional<GraphCache> cache;
+    if (options.count("sin-cache") == 0) {
+        cache.emplace(path);
+        if (auto cached = cache->load(mode)) {
+            return std::make_shared<const CsrGraph>(std::move(*cached));
+        }
+    }
+
+    auto graph = threads > 1
+                     ? read_graph_parallel(path, mode, threads)
+                     : CsrGraph(*GraphReader(path, mode).get_graph());
+
+    // El índice de alcanzabilidad se construye antes de escribir la caché,
+    // para que se guarde con ella y las ejecuciones siguientes no lo
+    // recalculen.
+    graph.build_reachability();
+    if (cache) {
+        cache->store(graph);
+    }
+
+    return std::make_shared<const CsrGraph>(std::move(graph));
+}
+
+/**
+ * @brief Carga un archivo de texto directamente en la representación
+ * comprimida. Si la caché está al día se comprime desde ella, que está
+ * mapeada en memoria; si no, el texto se lee a un Graph y se comprime fila
+ * por fila, sin armar antes un CsrGraph, de modo que nunca hay dos copias
+ * completas de las aristas en memoria. En este caso la caché no se
+ * escribe, porque se genera a partir de un CsrGraph.
+ * @param path Ruta del archivo.
+ * @param mode Tipo de grafo.
+ * @param options Opciones de la línea de comandos.
+ * @return Grafo comprimido.
+ */
+CompressedGraph load_compressed(
+    const std::string& path, GraphMode mode,
+    const std::map<std::string, std::string>& options) {
+    if (options.count("sin-cache") == 0) {
+        GraphCache cache(path);
+        if (const auto cached = cache.load(mode)) {
+            return CompressedGraph(*cached);
+        }
+    }
+
+    const GraphReader reader(path, mode);
+    return CompressedGraph(*reader.get_graph());
+}
+
+/**
+ * @brief Indica si hay un camino del origen al destino del grafo y, si no
+ * lo hay, lo informa. Se usa el índice de alcanzabilidad del grafo si ya lo
+ * tiene (por ejemplo, leído de un snapshot); si no, se calcula aquí.
+ * @param graph Grafo cargado.
+ * @return true si el destino es alcanzable desde el origen.
+ */
+template <typename G>
+bool check_reachable(const G& graph) {
+    std::optional<ReachabilityIndex> built;
+    const auto& reachability = graph.has_reachability()
+                                   ? graph.reachability()
+                                   : built.emplace(graph);
+    if (reachability.reachable(graph.start_id(), graph.end_id())) {
+        return true;
+    }
+
+    fmt::print("No existe un camino de {} a {}\n",
+               graph.node_name(graph.start_id()),
+               graph.node_name(graph.end_id()));
+    return false;
+}
+
+/**
+ * @brief Imprime el camino encontrado por un solver, su costo y el número de
+ * expansiones de cada nodo del camino, o un aviso si el solver no encontró
+ * ninguno.
+ * @param solver Solver ya ejecutado.
+ */
+template <typename S>
+void print_solution(const S& solver) {
+    const auto solution = solver.solution();
+    if (solution.empty()) {
+        fmt::print("No se encontró un camino\n");
+        return;
+    }
+
+    fmt::print("{}\n", fmt::join(solution, " -> "));
+    fmt::print("Costo: {}\n", solver.cost());
+
+    // Se recorren los nodos del camino, ordenados por nombre igual que el
+    // mapa de visitas, y no todas las visitas, que pueden ser muchas más.
+    const auto visit_count = solver.visit_count();
+    const std::set<std::string> path_nodes(std::cbegin(solution),
+                                           std::cend(solution));
+    for (const auto& node : path_nodes) {
+        if (const auto it = visit_count.find(node);
+            it != std::cend(visit_count)) {
+            fmt::print("{}: {}\n", node, it->second);
+        }
+    }
+}
+
+/**
+ * @brief Heurística elegida en la línea de comandos.
+ */
+struct HeuristicChoice {
+    std::string kind;
+    std::optional<Coordinates> coordinates;
+    double scale = 1;
+};
+
+/**
+ * @brief Resuelve el problema con el algoritmo indicado, usando la cola de
+ * prioridad `Q` en UCS y A*, e imprime la solución.
+ * @param g Grafo sobre el que se busca.
+ * @param algo Nombre del algoritmo.
+ * @param heuristic Heurística de A*, greedy y DFS.
+ * @return false si el algoritmo no existe, true en caso contrario.
+ */
+template <template <typename> class Q, typename G, typename H>
+bool solve_with_queue(const G& g, const std::string& algo,
+                      const H& heuristic) {
+    if (algo == "dfs") {
+        print_solution(DFSSolver(g, heuristic));
+    } else if (algo == "ucs") {
+        print_solution(UCSSolver<G, Q>(g));
+    } else if (algo == "greedy") {
+        print_solution(GreedySolver(g, heuristic));
+    } else if (algo == "a-star") {
+        print_solution(AStarSolver<G, H, Q>(g, heuristic));
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Resuelve el problema con el algoritmo y la cola de prioridad
+ * indicados e imprime la solución.
+ * @param g Grafo sobre el que se busca.
+ * @param algo Nombre del algoritmo.
+ * @param heuristic Heurística de A*, greedy y DFS.
+ * @param queue Nombre de la cola de prioridad.
+ * @return false si el algoritmo no existe, true en caso contrario.
+ * @throws std::invalid_argument si la cola no admite el tipo de los pesos.
+ */
+template <typename G, typename H>
+bool solve(const G& g, const std::string& algo, const H& heuristic,
+           const std::string& queue) {
+    if (queue == "binaria") {
+        return solve_with_queue<BinaryHeap>(g, algo, heuristic);
+    }
+
+    if (queue == "4-aria") {
+        return solve_with_queue<FourAryHeap>(g, algo, heuristic);
+    }
+
+    if (queue == "8-aria") {
+        return solve_with_queue<EightAryHeap>(g, algo, heuristic);
+    }
+
+    if (queue == "pairing") {
+        return solve_with_queue<PairingHeap>(g, algo, heuristic);
+    }
+
+    if (queue == "radix") {
+        return solve_with_queue<RadixHeap>(g, algo, heuristic);
+    }
+
+    if (queue == "dial") {
+        if constexpr (std::is_integral_v<graph_cost_t<G>>) {
+            return solve_with_queue<DialQueue>(g, algo, heuristic);
+        } else {
+            throw std::invalid_argument("La cola dial requiere pesos enteros");
+        }
+    }
+
+    return solve_with_queue<IndexedHeap>(g, algo, heuristic);
+}
+
+/**
+ * @brief Construye la heurística elegida hacia el destino del grafo y
+ * resuelve el problema con ella.
+ * @param g Grafo sobre el que se busca.
+ * @param algo Nombre del algoritmo.
+ * @param choice Heurística elegida.
+ * @param queue Nombre de la cola de prioridad.
+ * @return false si el algoritmo no existe, true en caso contrario.
+ */
+template <typename G>
+bool solve(const G& g, const std::string& algo, const HeuristicChoice& choice,
+           const std::string& queue) {
+    if (choice.kind == "euclidiana") {
+        return solve(g, algo,
+                     EuclideanHeuristic(*choice.coordinates, g.end_id(),
+                                        choice.scale),
+                     queue);
+    }
+
+    if (choice.kind == "manhattan") {
+        return solve(g, algo,
+                     ManhattanHeuristic(*choice.coordinates, g.end_id(),
+                                        choice.scale),
+                     queue);
+    }
+
+    if (choice.kind == "haversine") {
+        return solve(g, algo,
+                     HaversineHeuristic(*choice.coordinates, g.end_id(),
+                                        choice.scale),
+                     queue);
+    }
+
+    return solve(g, algo, FileHeuristic<G>(g), queue);
+}
+
+/**
+ * @brief Cambia el tipo de los pesos del grafo y resuelve sobre la copia. El
+ * grafo original se libera antes de resolver.
+ * @param loaded Grafo cargado.
+ * @param algo Nombre del algoritmo.
+ * @param heuristic Heurística elegida.
+ * @param queue Nombre de la cola de prioridad.
+ * @return false si el algoritmo no existe, true en caso contrario.
+ */
+template <typename W>
+bool solve_with_weights(std::shared_ptr<const CsrGraph>& loaded,
+                        const std::string& algo,
+                        const HeuristicChoice& heuristic,
+                        const std::string& queue) {
+    const auto graph = convert_weights<W>(*loaded);
+    loaded.reset();
+
+    return solve(graph, algo, heuristic, queue);
+}
+
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        fmt::print(stderr, "Uso: {} <algo> <path>\n", argv[0]);
+    // Las opciones tienen la forma --nombre=valor y pueden ir en cualquier
+    // posición; el resto de los argumentos son posicionales.
+    std::map<std::string, std::string> options;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+
+        if (arg.rfind("--", 0) != 0) {
+            args.push_back(arg);
+            continue;
+        }
+
+        const auto eq = arg.find('=');
+        if (eq == std::string::npos) {
+            options[arg.substr(2)] = "";
+        } else {
+            options[arg.substr(2, eq - 2)] = arg.substr(eq + 1);
+        }
+    }
+
+    if (args.size() != 2) {
+        fmt::print(stderr,
+                   "Uso: {} [--no-dirigido] [--hilos=<n>] "
+                   "[--formato=texto|dimacs] [--coordenadas=<archivo.co>] "
+                   "[--origen=<nodo>] [--destino=<nodo>] "
+                   "[--sin-cache] [--reordenar=bfs|rcm] "
+                   "[--guardar=<snapshot>] "
+                   "[--representacion=csr|comprimida] "
+                   "[--pesos=int|u16|u32|u64|float] "
+                   "[--heuristica=archivo|euclidiana|manhattan|haversine] "
+                   "[--escala-heuristica=<factor>] "
+                   "[--cola=indexada|binaria|4-aria|8-aria|pairing|radix|dial] "
+                   "[--verificar] "
+                   "<algo> <path>\n",
+                   argv[0]);
+        return 1;
+    }
+
+    for (const auto& [option, _] : options) {
+        if (option != "cola" && option != "coordenadas" &&
+            option != "destino" && option != "escala-heuristica" &&
+            option != "formato" && option != "guardar" &&
+            option != "heuristica" && option != "hilos" &&
+            option != "no-dirigido" && option != "origen" &&
+            option != "pesos" && option != "reordenar" &&
+            option != "representacion" && option != "sin-cache" &&
+            option != "verificar") {
+            fmt::print(stderr, "{}: Opción desconocida: --{}\n", argv[0],
+                       option);
+            return 1;
+        }
+    }
+
+    const auto representation = options["representacion"];
+    if (!representation.empty() && representation != "csr" &&
+        representation != "comprimida") {
+        fmt::print(stderr, "{}: Representación desconocida: {}\n", argv[0],
+                   representation);
         return 1;
     }
 
-    GraphReader reader(argv[2]);
-    Graph g(reader.get_graph());
+    const auto weights = options["pesos"];
+    if (!weights.empty() && weights != "int" && weights != "u16" &&
+        weights != "u32" && weights != "u64" && weights != "float") {
+        fmt::print(stderr, "{}: Tipo de pesos desconocido: {}\n", argv[0],
+                   weights);
+        return 1;
+    }
 
-    const std::string algo = argv[1];
+    if (representation == "comprimida" && !weights.empty() &&
+        weights != "int") {
+        fmt::print(stderr,
+                   "{}: La representación comprimida solo admite pesos int\n",
+                   argv[0]);
+        return 1;
+    }
 
-    if (algo == "dfs") {
-        const DFSSolver solver(g);
-        const auto solution = solver.solution();
+    const auto queue = options["cola"];
+    if (!queue.empty() && queue != "indexada" && queue != "binaria" &&
+        queue != "4-aria" && queue != "8-aria" && queue != "pairing" &&
+        queue != "radix" && queue != "dial") {
+        fmt::print(stderr, "{}: Cola de prioridad desconocida: {}\n", argv[0],
+                   queue);
+        return 1;
+    }
 
-        fmt::print("{}\n", fmt::join(solution, " -> "));
-        fmt::print("Costo: {}\n", solver.cost());
+    if (queue == "dial" && weights == "float") {
+        fmt::print(stderr, "{}: La cola dial requiere pesos enteros\n",
+                   argv[0]);
+        return 1;
+    }
 
-        for (const auto& [node, count] : solver.visit_count()) {
-            if (std::find(std::cbegin(solution), std::cend(solution), node) ==
-                solution.end()) {
-                continue;
-            }
+    const auto format = options["formato"];
+    if (!format.empty() && format != "texto" && format != "dimacs") {
+        fmt::print(stderr, "{}: Formato desconocido: {}\n", argv[0], format);
+        return 1;
+    }
+
+    if (format != "dimacs" &&
+        (options.count("coordenadas") != 0 || options.count("origen") != 0 ||
+         options.count("destino") != 0)) {
+        fmt::print(stderr,
+                   "{}: --coordenadas, --origen y --destino solo se usan con "
+                   "--formato=dimacs\n",
+                   argv[0]);
+        return 1;
+    }
 
-            fmt::print("{}: {}\n", node, count);
+    HeuristicChoice heuristic;
+    heuristic.kind = options["heuristica"];
+    if (!heuristic.kind.empty() && heuristic.kind != "archivo" &&
+        heuristic.kind != "euclidiana" && heuristic.kind != "manhattan" &&
+        heuristic.kind != "haversine") {
+        fmt::print(stderr, "{}: Heurística desconocida: {}\n", argv[0],
+                   heuristic.kind);
+        return 1;
+    }
+
+    if (const auto it = options.find("escala-heuristica");
+        it != options.end()) {
+        const auto& value = it->second;
+        const auto [end, ec] = std::from_chars(
+            value.data(), value.data() + value.size(), heuristic.scale);
+        if (ec != std::errc() || end != value.data() + value.size() ||
+            !(heuristic.scale >= 0)) {
+            fmt::print(stderr, "{}: Escala de heurística inválida: {}\n",
+                       argv[0], value);
+            return 1;
         }
-    } else if (algo == "ucs") {
-        const UCSSolver solver(g);
-        const auto solution = solver.solution();
+    }
 
-        fmt::print("{}\n", fmt::join(solution, " -> "));
-        fmt::print("Costo: {}\n", solver.cost());
+    unsigned threads = 1;
+    if (const auto it = options.find("hilos"); it != options.end()) {
+        const auto& value = it->second;
+        const auto [end, ec] =
+            std::from_chars(value.data(), value.data() + value.size(), threads);
+        if (ec != std::errc() || end != value.data() + value.size() ||
+            threads == 0) {
+            fmt::print(stderr, "{}: Número de hilos inválido: {}\n", argv[0],
+                       value);
+            return 1;
+        }
+    }
 
-        for (const auto& [node, count] : solver.visit_count()) {
-            if (std::find(std::cbegin(solution), std::cend(solution), node) ==
-                solution.end()) {
-                continue;
-            }
+    const std::string algo = args[0];
+    if (algo != "dfs" && algo != "ucs" && algo != "greedy" &&
+        algo != "a-star") {
+        fmt::print(stderr, "{}: Algoritmo desconocido: {}\n", argv[0], algo);
+        return 1;
+    }
 
-            fmt::print("{}: {}\n", node, count);
+    const auto mode = options.count("no-dirigido") != 0
+                          ? GraphMode::undirected
+                          : GraphMode::directed;
+
+    // Un archivo de texto que se va a resolver en la representación
+    // comprimida se comprime mientras se carga, salvo que haya que
+    // renumerarlo o guardarlo, para lo que se necesita un CsrGraph. Los
+    // snapshots se mapean en memoria, así que comprimirlos después de
+    // abrirlos no duplica el grafo.
+    const bool compress_on_load =
+        representation == "comprimida" && format != "dimacs" &&
+        options.count("reordenar") == 0 && options.count("guardar") == 0 &&
+        !is_snapshot(args[1]);
+
+    std::shared_ptr<const CsrGraph> loaded;
+    std::optional<CompressedGraph> compressed;
+    try {
+        if (compress_on_load) {
+            compressed.emplace(load_compressed(args[1], mode, options));
+        } else {
+            loaded = load_graph(args[1], mode, threads, options);
+        }
+
+        // La renumeración se aplica antes de guardar, para que el snapshot
+        // quede con el nuevo orden y no haya que repetirla.
+        if (const auto it = options.find("reordenar"); it != options.end()) {
+            if (it->second == "bfs") {
+                loaded = std::make_shared<const CsrGraph>(
+                    reorder(*loaded, bfs_order(*loaded)));
+            } else if (it->second == "rcm") {
+                loaded = std::make_shared<const CsrGraph>(
+                    reorder(*loaded, rcm_order(*loaded)));
+            } else {
+                throw std::invalid_argument("Orden desconocido: " +
+                                            it->second);
+            }
         }
-    } else if (algo == "greedy") {
-        const GreedySolver solver(g);
-        const auto solution = solver.solution();
 
-        fmt::print("{}\n", fmt::join(solution, " -> "));
-        fmt::print("Costo: {}\n", solver.cost());
+        if (const auto it = options.find("guardar"); it != options.end()) {
+            write_snapshot(*loaded, it->second, SnapshotSource{});
+        }
 
-        for (const auto& [node, count] : solver.visit_count()) {
-            if (std::find(std::cbegin(solution), std::cend(solution), node) ==
-                solution.end()) {
-                continue;
+        // Las coordenadas se copian aparte, porque el grafo cargado se
+        // libera al cambiar de representación o de tipo de pesos.
+        if (!heuristic.kind.empty() && heuristic.kind != "archivo") {
+            if (!loaded || !loaded->has_coordinates()) {
+                throw std::invalid_argument(
+                    "La heurística " + heuristic.kind +
+                    " requiere un grafo con coordenadas");
             }
 
-            fmt::print("{}: {}\n", node, count);
+            heuristic.coordinates.emplace(loaded->coordinates());
         }
-    } else if (algo == "a-star") {
-        const AStarSolver solver(g);
-        const auto solution = solver.solution();
 
-        fmt::print("{}\n", fmt::join(solution, " -> "));
-        fmt::print("Costo: {}\n", solver.cost());
+        // Si el destino no es alcanzable, la respuesta se conoce sin buscar.
+        if (compressed ? !check_reachable(*compressed)
+                       : !check_reachable(*loaded)) {
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "{}: {}\n", argv[0], e.what());
+        return 1;
+    }
 
-        for (const auto& [node, count] : solver.visit_count()) {
-            if (std::find(std::cbegin(solution), std::cend(solution), node) ==
-                solution.end()) {
-                continue;
+    bool solved;
+    try {
+        if (representation == "comprimida") {
+            if (!compressed) {
+                compressed.emplace(*loaded);
+                loaded.reset();
             }
 
-            fmt::print("{}: {}\n", node, count);
+            solved = solve(*compressed, algo, heuristic, queue);
+        } else if (weights == "u16") {
+            solved = solve_with_weights<std::uint16_t>(loaded, algo,
+                                                       heuristic, queue);
+        } else if (weights == "u32") {
+            solved = solve_with_weights<std::uint32_t>(loaded, algo,
+                                                       heuristic, queue);
+        } else if (weights == "u64") {
+            solved = solve_with_weights<std::uint64_t>(loaded, algo,
+                                                       heuristic, queue);
+        } else if (weights == "float") {
+            solved = solve_with_weights<float>(loaded, algo, heuristic, queue);
+        } else {
+            solved = solve(*loaded, algo, heuristic, queue);
         }
-    } else {
+    } catch (const std::exception& e) {
+        fmt::print(stderr, "{}: {}\n", argv[0], e.what());
+        return 1;
+    }
+
+    if (!solved) {
         fmt::print(stderr, "{}: Algoritmo desconocido: {}\n", argv[0], algo);
         return 1;
     }
@@ -0,0 +1,73 @@
+#include "mappedfile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * @brief Constructor. Mapea un archivo completo en memoria.
+ * @param path Ruta del archivo.
+ * @throws std::runtime_error si el archivo no se puede abrir o mapear.
+ */
+MappedFile::MappedFile(const std::string& path) : m_data(nullptr), m_size(0) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + ": " +
+                                 std::strerror(errno));
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) < 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path + ": " +
+                                 std::strerror(error));
+    }
+
+    m_size = static_cast<std::size_t>(st.st_size);
+
+    // mmap no acepta regiones vacías; un archivo vacío queda sin mapear.
+    if (m_size > 0) {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            const int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot map " + path + ": " +
+                                     std::strerror(error));
+        }
+
+        m_data = static_cast<const char*>(data);
+    }
+
+    ::close(fd);
+}
+
+/**
+ * @brief Destructor. Libera la región mapeada.
+ */
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+/**
+ * @brief Obtiene el inicio de la región mapeada.
+ * @return Puntero al primer byte del archivo.
+ */
+const char* MappedFile::data() const {
+    return m_data;
+}
+
+/**
+ * @brief Obtiene el tamaño del archivo mapeado.
+ * @return Tamaño del archivo, en bytes.
+ */
+std::size_t MappedFile::size() const {
+    return m_size;
+}
@@ -0,0 +1,362 @@
+#include "reachability.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "compressedgraph.h"
+#include "csrgraph.h"
+
+/**
+ * @brief Calcula las componentes fuertemente conexas con el algoritmo de
+ * Tarjan, en su versión iterativa para no agotar la pila en grafos grandes.
+ * Cada componente recibe su número al cerrarse, así que toda arista entre
+ * componentes va de un número mayor a uno menor: los números están en orden
+ * topológico inverso.
+ */
+template <typename G>
+void ReachabilityIndex::find_components(const G& graph, Arrays& arrays) {
+    const auto node_count = static_cast<NodeId>(graph.vertex_count());
+
+    constexpr auto unvisited = Graph::invalid_node;
+
+    // Orden de descubrimiento de cada nodo y el menor orden alcanzable desde
+    // su subárbol sin salir de las componentes abiertas.
+    std::vector<NodeId> index(node_count, unvisited);
+    std::vector<NodeId> low(node_count);
+
+    // Nodos de las componentes que aún no se cierran. Un nodo está en esta
+    // pila si ya se descubrió y todavía no tiene componente.
+    std::vector<NodeId> open;
+
+    // Pila de llamadas: cada marco guarda el nodo y la próxima arista que
+    // falta recorrer.
+    using Iterator = decltype(graph.neighbors(0).begin());
+    struct Frame {
+        NodeId node;
+        Iterator edge;
+        Iterator last;
+    };
+    std::vector<Frame> calls;
+
+    auto& components = arrays.component;
+    components.assign(node_count, unvisited);
+    NodeId next_index = 0;
+    NodeId component_count = 0;
+
+    const auto discover = [&](NodeId node) {
+        index[node] = low[node] = next_index++;
+        open.push_back(node);
+        const auto neighbors = graph.neighbors(node);
+        calls.push_back({node, neighbors.begin(), neighbors.end()});
+    };
+
+    for (NodeId root = 0; root < node_count; ++root) {
+        if (index[root] != unvisited) {
+            continue;
+        }
+
+        discover(root);
+        while (!calls.empty()) {
+            auto& frame = calls.back();
+            const auto node = frame.node;
+
+            if (frame.edge != frame.last) {
+                const auto next = (*frame.edge).first;
+                ++frame.edge;
+
+                if (index[next] == unvisited) {
+                    discover(next);
+                } else if (components[next] == unvisited) {
+                    low[node] = std::min(low[node], index[next]);
+                }
+
+                continue;
+            }
+
+            // Se recorrieron todas las aristas del nodo. Si es la raíz de su
+            // componente, la cerramos con los nodos abiertos sobre él.
+            if (low[node] == index[node]) {
+                NodeId member;
+                do {
+                    member = open.back();
+                    open.pop_back();
+                    components[member] = component_count;
+                } while (member != node);
+
+                component_count++;
+            }
+
+            calls.pop_back();
+            if (!calls.empty()) {
+                const auto parent = calls.back().node;
+                low[parent] = std::min(low[parent], low[node]);
+            }
+        }
+    }
+
+    arrays.weak.resize(component_count);
+    arrays.level.assign(component_count, 0);
+}
+
+/**
+ * @brief Construye el DAG de condensación y, sobre él, las componentes
+ * débilmente conexas y el nivel de cada componente.
+ */
+template <typename G>
+void ReachabilityIndex::build_condensation(const G& graph, Arrays& arrays) {
+    const auto node_count = static_cast<NodeId>(graph.vertex_count());
+    const auto& components = arrays.component;
+    auto& weak = arrays.weak;
+    auto& level = arrays.level;
+    auto& dag_offsets = arrays.dag_offsets;
+    auto& dag_targets = arrays.dag_targets;
+    const auto component_count = weak.size();
+
+    // Repartir las aristas entre componentes por componente de origen, con
+    // un ordenamiento por conteo, y después quitar las repetidas de cada
+    // fila.
+    dag_offsets.assign(component_count + 1, 0);
+    for (NodeId node = 0; node < node_count; ++node) {
+        for (const auto [to, _] : graph.neighbors(node)) {
+            if (components[to] != components[node]) {
+                dag_offsets[components[node] + 1]++;
+            }
+        }
+    }
+
+    std::partial_sum(std::cbegin(dag_offsets), std::cend(dag_offsets),
+                     std::begin(dag_offsets));
+
+    dag_targets.resize(dag_offsets[component_count]);
+    std::vector<std::uint64_t> next(std::cbegin(dag_offsets),
+                                    std::cend(dag_offsets) - 1);
+    for (NodeId node = 0; node < node_count; ++node) {
+        for (const auto [target, _] : graph.neighbors(node)) {
+            const auto from = components[node];
+            const auto to = components[target];
+            if (from != to) {
+                dag_targets[next[from]++] = to;
+            }
+        }
+    }
+
+    std::uint64_t kept = 0;
+    for (std::size_t c = 0; c < component_count; ++c) {
+        const auto first = std::begin(dag_targets) + dag_offsets[c];
+        const auto last = std::begin(dag_targets) + dag_offsets[c + 1];
+        std::sort(first, last);
+
+        dag_offsets[c] = kept;
+        const auto unique_last = std::unique(first, last);
+        kept = std::copy(first, unique_last,
+                         std::begin(dag_targets) + kept) -
+               std::begin(dag_targets);
+    }
+
+    dag_offsets[component_count] = kept;
+    dag_targets.resize(kept);
+    dag_targets.shrink_to_fit();
+
+    // Componentes débilmente conexas, con conjuntos disjuntos sobre las
+    // aristas del DAG.
+    std::iota(std::begin(weak), std::end(weak), 0);
+    const auto find = [&weak](NodeId c) {
+        while (weak[c] != c) {
+            weak[c] = weak[weak[c]];
+            c = weak[c];
+        }
+        return c;
+    };
+
+    for (NodeId c = 0; c < component_count; ++c) {
+        for (auto edge = dag_offsets[c]; edge < dag_offsets[c + 1];
+             ++edge) {
+            const auto a = find(c);
+            const auto b = find(dag_targets[edge]);
+            weak[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    for (NodeId c = 0; c < component_count; ++c) {
+        weak[c] = find(c);
+    }
+
+    // Niveles: se recorren las componentes en orden topológico, es decir,
+    // de la de mayor número a la de menor.
+    for (auto c = component_count; c-- > 0;) {
+        for (auto edge = dag_offsets[c]; edge < dag_offsets[c + 1];
+             ++edge) {
+            auto& next = level[dag_targets[edge]];
+            next = std::max(next, level[c] + 1);
+        }
+    }
+}
+
+/**
+ * @brief Constructor. Calcula el índice en tiempo lineal en el tamaño del
+ * grafo (más el orden de las aristas de cada componente del DAG).
+ * @param graph Grafo a indexar.
+ */
+template <typename G>
+ReachabilityIndex::ReachabilityIndex(const G& graph) {
+    auto arrays = std::make_shared<Arrays>();
+    find_components(graph, *arrays);
+    build_condensation(graph, *arrays);
+
+    m_component = arrays->component;
+    m_weak = arrays->weak;
+    m_level = arrays->level;
+    m_dag_offsets = arrays->dag_offsets;
+    m_dag_targets = arrays->dag_targets;
+    m_storage = std::move(arrays);
+}
+
+template ReachabilityIndex::ReachabilityIndex(const BasicCsrGraph<int>&);
+template ReachabilityIndex::ReachabilityIndex(
+    const BasicCsrGraph<std::uint16_t>&);
+template ReachabilityIndex::ReachabilityIndex(
+    const BasicCsrGraph<std::uint32_t>&);
+template ReachabilityIndex::ReachabilityIndex(
+    const BasicCsrGraph<std::uint64_t>&);
+template ReachabilityIndex::ReachabilityIndex(const BasicCsrGraph<float>&);
+template ReachabilityIndex::ReachabilityIndex(const CompressedGraph&);
+
+/**
+ * @brief Devuelve el número de componentes fuertemente conexas.
+ */
+std::size_t ReachabilityIndex::component_count() const {
+    return m_weak.size();
+}
+
+/**
+ * @brief Devuelve la componente fuertemente conexa de un nodo.
+ */
+NodeId ReachabilityIndex::component(NodeId node) const {
+    return m_component[node];
+}
+
+/**
+ * @brief Prepara el espacio para una consulta sobre un índice de
+ * `component_count` componentes. Los arreglos solo crecen.
+ */
+void ReachabilityWorkspace::reset(std::size_t component_count) {
+    if (m_seen.size() < component_count) {
+        m_seen.resize(component_count, 0);
+    }
+
+    // Al dar la vuelta el contador, una marca vieja podría coincidir con la
+    // nueva generación, así que las marcas se borran una vez.
+    if (++m_generation == 0) {
+        std::fill(std::begin(m_seen), std::end(m_seen), 0);
+        m_generation = 1;
+    }
+
+    m_pending.clear();
+}
+
+/**
+ * @brief Indica si hay un camino de un nodo a otro, con un espacio de trabajo
+ * propio. Ver la versión que recibe un ReachabilityWorkspace.
+ * @param from Nodo de origen.
+ * @param to Nodo de destino.
+ * @return true si el destino es alcanzable desde el origen.
+ */
+bool ReachabilityIndex::reachable(NodeId from, NodeId to) const {
+    ReachabilityWorkspace workspace;
+    return reachable(from, to, workspace);
+}
+
+/**
+ * @brief Indica si hay un camino de un nodo a otro. Los casos comunes se
+ * responden en tiempo constante: dos nodos de la misma componente fuerte
+ * siempre están conectados, y no hay camino si están en componentes débiles
+ * distintas o si el nivel del destino no es mayor que el del origen. En el
+ * resto de los casos se recorre el DAG de condensación, que suele ser mucho
+ * más pequeño que el grafo, descartando las componentes con nivel igual o
+ * mayor al del destino.
+ *
+ * El índice no se modifica: las componentes visitadas se marcan en el
+ * espacio de trabajo, que se puede reutilizar entre consultas para no
+ * reservar ni limpiar un arreglo por componente en cada una.
+ * @param from Nodo de origen.
+ * @param to Nodo de destino.
+ * @param workspace Espacio de trabajo. Su contenido anterior se descarta.
+ * @return true si el destino es alcanzable desde el origen.
+ */
+bool ReachabilityIndex::reachable(NodeId from, NodeId to,
+                                  ReachabilityWorkspace& workspace) const {
+    const auto source = m_component[from];
+    const auto target = m_component[to];
+
+    if (source == target) {
+        return true;
+    }
+
+    if (m_weak[source] != m_weak[target] ||
+        m_level[source] >= m_level[target]) {
+        return false;
+    }
+
+    workspace.reset(component_count());
+    auto& seen = workspace.m_seen;
+    auto& pending = workspace.m_pending;
+    const auto generation = workspace.m_generation;
+
+    pending.push_back(source);
+    seen[source] = generation;
+
+    while (!pending.empty()) {
+        const auto c = pending.back();
+        pending.pop_back();
+
+        for (auto edge = m_dag_offsets[c]; edge < m_dag_offsets[c + 1];
+             ++edge) {
+            const auto next = m_dag_targets[edge];
+            if (next == target) {
+                return true;
+            }
+
+            if (seen[next] != generation && m_level[next] < m_level[target]) {
+                seen[next] = generation;
+                pending.push_back(next);
+            }
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Obtiene la componente fuertemente conexa de cada nodo.
+ */
+ArrayView<NodeId> ReachabilityIndex::components() const {
+    return m_component;
+}
+
+/**
+ * @brief Obtiene la componente débilmente conexa de cada componente fuerte.
+ */
+ArrayView<NodeId> ReachabilityIndex::weak_components() const {
+    return m_weak;
+}
+
+/**
+ * @brief Obtiene el nivel de cada componente en el DAG de condensación.
+ */
+ArrayView<NodeId> ReachabilityIndex::levels() const {
+    return m_level;
+}
+
+/**
+ * @brief Obtiene los inicios de fila del DAG de condensación.
+ */
+ArrayView<std::uint64_t> ReachabilityIndex::dag_offsets() const {
+    return m_dag_offsets;
+}
+
+/**
+ * @brief Obtiene los destinos de las aristas del DAG de condensación.
+ */
+ArrayView<NodeId> ReachabilityIndex::dag_targets() const {
+    return m_dag_targets;
+}
@@ -0,0 +1,273 @@
+#include "reorder.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+/*
+ * Los órdenes se representan como un arreglo `order` en que `order[i]` es el
+ * identificador original del nodo que pasa a tener el identificador `i`.
+ * Como los nombres se mueven junto con los nodos, la salida de los solvers
+ * (que usa nombres) no cambia; `order` sirve como tabla de traducción si se
+ * necesitan los identificadores originales.
+ */
+
+namespace {
+
+/**
+ * @brief Recorre en anchura la componente de `root`, agregando los nodos a
+ * `order` en el orden en que se descubren.
+ * @param by_degree Si es true, los vecinos de cada nodo se visitan de menor a
+ * mayor grado, como en Cuthill-McKee.
+ */
+template <typename W>
+void bfs_from(const BasicCsrGraph<W>& graph, NodeId root, bool by_degree,
+              std::vector<bool>& visited, std::vector<NodeId>& order) {
+    const auto offsets = graph.offsets();
+    const auto degree = [&offsets](NodeId node) {
+        return offsets[node + 1] - offsets[node];
+    };
+
+    std::vector<NodeId> children;
+
+    visited[root] = true;
+    order.push_back(root);
+
+    // `order` hace de cola: los nodos de la componente se agregan al final y
+    // se procesan en el mismo orden.
+    for (auto head = order.size() - 1; head < order.size(); ++head) {
+        children.clear();
+        for (const auto& [neighbor, _] : graph.neighbors(order[head])) {
+            if (!visited[neighbor]) {
+                visited[neighbor] = true;
+                children.push_back(neighbor);
+            }
+        }
+
+        if (by_degree) {
+            std::stable_sort(std::begin(children), std::end(children),
+                             [&degree](NodeId lhs, NodeId rhs) {
+                                 return degree(lhs) < degree(rhs);
+                             });
+        }
+
+        order.insert(std::end(order), std::cbegin(children),
+                     std::cend(children));
+    }
+}
+
+/**
+ * @brief Busca un nodo pseudoperiférico entre los nodos no visitados que se
+ * alcanzan desde `root`: repite recorridos en anchura desde el nodo más lejano
+ * encontrado (el de menor grado entre los del último nivel) mientras la
+ * excentricidad aumente.
+ */
+template <typename W>
+NodeId pseudo_peripheral(const BasicCsrGraph<W>& graph, NodeId root,
+                         const std::vector<bool>& visited,
+                         std::vector<std::size_t>& level) {
+    const auto offsets = graph.offsets();
+    const auto degree = [&offsets](NodeId node) {
+        return offsets[node + 1] - offsets[node];
+    };
+
+    std::vector<NodeId> queue;
+    std::size_t eccentricity = 0;
+
+    while (true) {
+        // `level` llega en cero y se deja en cero al terminar cada recorrido,
+        // para no limpiar el arreglo completo en cada componente.
+        queue.assign(1, root);
+        level[root] = 1;
+
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            for (const auto& [neighbor, _] : graph.neighbors(queue[head])) {
+                if (level[neighbor] == 0 && !visited[neighbor]) {
+                    level[neighbor] = level[queue[head]] + 1;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+
+        const auto last_level = level[queue.back()];
+
+        NodeId candidate = queue.back();
+        for (auto it = queue.rbegin();
+             it != queue.rend() && level[*it] == last_level; ++it) {
+            if (degree(*it) < degree(candidate)) {
+                candidate = *it;
+            }
+        }
+
+        for (const auto node : queue) {
+            level[node] = 0;
+        }
+
+        if (last_level <= eccentricity) {
+            return root;
+        }
+
+        eccentricity = last_level;
+        root = candidate;
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief Calcula un orden de los nodos por recorrido en anchura. El recorrido
+ * parte del nodo de origen (si está definido) y continúa con las componentes
+ * que no se alcanzaron, de modo que los vecinos quedan cerca en memoria.
+ * @param graph Grafo a ordenar.
+ * @return Orden de los nodos.
+ */
+template <typename W>
+std::vector<NodeId> bfs_order(const BasicCsrGraph<W>& graph) {
+    const auto node_count = graph.vertex_count();
+
+    std::vector<bool> visited(node_count, false);
+    std::vector<NodeId> order;
+    order.reserve(node_count);
+
+    try {
+        bfs_from(graph, graph.start_id(), false, visited, order);
+    } catch (const std::runtime_error&) {
+        // Sin nodo de origen, el recorrido parte del primer nodo.
+    }
+
+    for (NodeId node = 0; node < node_count; ++node) {
+        if (!visited[node]) {
+            bfs_from(graph, node, false, visited, order);
+        }
+    }
+
+    return order;
+}
+
+/**
+ * @brief Calcula un orden de los nodos con el algoritmo de Cuthill-McKee
+ * inverso, que minimiza el ancho de banda de la matriz de adyacencia. Cada
+ * componente se recorre desde un nodo pseudoperiférico.
+ * @param graph Grafo a ordenar.
+ * @return Orden de los nodos.
+ */
+template <typename W>
+std::vector<NodeId> rcm_order(const BasicCsrGraph<W>& graph) {
+    const auto node_count = graph.vertex_count();
+
+    std::vector<bool> visited(node_count, false);
+    std::vector<std::size_t> level(node_count, 0);
+    std::vector<NodeId> order;
+    order.reserve(node_count);
+
+    // En un grafo dirigido el recorrido desde el nodo pseudoperiférico puede
+    // no alcanzar a `node`, así que solo se avanza cuando ya fue visitado.
+    for (NodeId node = 0; node < node_count;) {
+        if (visited[node]) {
+            ++node;
+            continue;
+        }
+
+        const auto root = pseudo_peripheral(graph, node, visited, level);
+        bfs_from(graph, root, true, visited, order);
+    }
+
+    std::reverse(std::begin(order), std::end(order));
+
+    return order;
+}
+
+/**
+ * @brief Renumera los nodos de un grafo. Las aristas, los pesos, las
+ * heurísticas, los nombres y los nodos de origen y destino se permutan de
+ * forma consistente.
+ * @param graph Grafo a renumerar.
+ * @param order Nuevo orden: `order[i]` es el nodo que pasa a ser el `i`.
+ * @return Grafo renumerado.
+ * @throws std::invalid_argument si `order` no es una permutación de los nodos.
+ */
+template <typename W>
+BasicCsrGraph<W> reorder(const BasicCsrGraph<W>& graph,
+                         const std::vector<NodeId>& order) {
+    const auto node_count = graph.vertex_count();
+
+    if (order.size() != node_count) {
+        throw std::invalid_argument("Order does not cover every node");
+    }
+
+    // Inversa de la permutación: identificador original -> nuevo.
+    std::vector<NodeId> new_id(node_count, Graph::invalid_node);
+    for (NodeId i = 0; i < node_count; ++i) {
+        if (order[i] >= node_count || new_id[order[i]] != Graph::invalid_node) {
+            throw std::invalid_argument("Order is not a permutation");
+        }
+
+        new_id[order[i]] = i;
+    }
+
+    const auto offsets = graph.offsets();
+    const auto name_offsets = graph.name_offsets();
+
+    typename BasicCsrGraph<W>::Arrays arrays;
+    arrays.offsets.reserve(node_count + 1);
+    arrays.targets.reserve(graph.edge_count());
+    arrays.weights.reserve(graph.edge_count());
+    arrays.heuristics.reserve(node_count);
+    arrays.name_offsets.reserve(node_count + 1);
+    arrays.names.reserve(graph.names().size());
+    arrays.coordinates.reserve(graph.coordinates().size());
+    arrays.mode = graph.mode();
+
+    arrays.offsets.push_back(0);
+    arrays.name_offsets.push_back(0);
+    for (const auto old_id : order) {
+        for (auto i = offsets[old_id]; i < offsets[old_id + 1]; ++i) {
+            arrays.targets.push_back(new_id[graph.targets()[i]]);
+            arrays.weights.push_back(graph.weights()[i]);
+        }
+        arrays.offsets.push_back(arrays.targets.size());
+
+        arrays.heuristics.push_back(graph.heuristics()[old_id]);
+        if (graph.has_coordinates()) {
+            arrays.coordinates.push_back(graph.coordinates()[old_id]);
+        }
+
+        const auto* name = graph.names().data() + name_offsets[old_id];
+        arrays.names.insert(std::end(arrays.names), name,
+                            name + (name_offsets[old_id + 1] -
+                                    name_offsets[old_id]));
+        arrays.name_offsets.push_back(arrays.names.size());
+    }
+
+    try {
+        arrays.start = new_id[graph.start_id()];
+        arrays.end = new_id[graph.end_id()];
+    } catch (const std::runtime_error&) {
+        // Un grafo sin origen o destino se renumera igual.
+    }
+
+    return BasicCsrGraph<W>(std::move(arrays));
+}
+
+template std::vector<NodeId> bfs_order(const BasicCsrGraph<int>&);
+template std::vector<NodeId> bfs_order(const BasicCsrGraph<std::uint16_t>&);
+template std::vector<NodeId> bfs_order(const BasicCsrGraph<std::uint32_t>&);
+template std::vector<NodeId> bfs_order(const BasicCsrGraph<std::uint64_t>&);
+template std::vector<NodeId> bfs_order(const BasicCsrGraph<float>&);
+
+template std::vector<NodeId> rcm_order(const BasicCsrGraph<int>&);
+template std::vector<NodeId> rcm_order(const BasicCsrGraph<std::uint16_t>&);
+template std::vector<NodeId> rcm_order(const BasicCsrGraph<std::uint32_t>&);
+template std::vector<NodeId> rcm_order(const BasicCsrGraph<std::uint64_t>&);
+template std::vector<NodeId> rcm_order(const BasicCsrGraph<float>&);
+
+template BasicCsrGraph<int> reorder(const BasicCsrGraph<int>&,
+                                    const std::vector<NodeId>&);
+template BasicCsrGraph<std::uint16_t> reorder(
+    const BasicCsrGraph<std::uint16_t>&, const std::vector<NodeId>&);
+template BasicCsrGraph<std::uint32_t> reorder(
+    const BasicCsrGraph<std::uint32_t>&, const std::vector<NodeId>&);
+template BasicCsrGraph<std::uint64_t> reorder(
+    const BasicCsrGraph<std::uint64_t>&, const std::vector<NodeId>&);
+template BasicCsrGraph<float> reorder(const BasicCsrGraph<float>&,
+                                      const std::vector<NodeId>&);
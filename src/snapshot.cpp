@@ -0,0 +1,585 @@
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+#include "mappedfile.h"
+
+/*
+ * Formato binario de un grafo congelado. El archivo comienza con un
+ * SnapshotHeader seguido de las secciones, en este orden y cada una rellenada
+ * hasta un múltiplo de 8 bytes:
+ *
+ *   offsets       uint64_t[V + 1]
+ *   name_offsets  uint64_t[V + 1]
+ *   targets       uint32_t[E]
+ *   weights       W[E]
+ *   heuristics    int32_t[V]
+ *   name_order    uint32_t[V]
+ *   names         char[names_size]
+ *   components    uint32_t[V]
+ *   weak          uint32_t[C]
+ *   levels        uint32_t[C]
+ *   dag_offsets   uint64_t[C + 1]
+ *   dag_targets   uint32_t[D]
+ *   hub_slots     FlatEdgeIndex::Slot[H]
+ *   coordinates   Point[V] (solo si `has_coordinates` es 1)
+ *
+ * Los datos se guardan en el orden de bytes de la máquina que los escribió;
+ * `byte_order` permite rechazar archivos escritos con otro orden. El
+ * `checksum` cubre la cabecera (con el propio campo en 0) y todas las
+ * secciones. `mode` es 0 para un grafo dirigido y
+ * 1 para uno no dirigido; la adyacencia inversa no se guarda. `weight_kind`
+ * identifica el tipo W de los pesos (ver weight_kind()). Los campos
+ * `source_*` identifican el archivo de texto del que el snapshot es caché
+ * (ver SnapshotSource).
+ *
+ * Las secciones `components` a `dag_targets` son el índice de alcanzabilidad
+ * del grafo (ver ReachabilityIndex), con `C = component_count` componentes
+ * fuertemente conexas y `D = dag_edge_count` aristas en el DAG de
+ * condensación. Se guardan para que abrir un snapshot o una caché no tenga
+ * que recalcularlo. Por lo mismo, `hub_slots` guarda la tabla de aristas de
+ * los nodos de grado alto (ver FlatEdgeIndex), con `H = hub_slot_count`
+ * ranuras.
+ *
+ * Al abrir un snapshot siempre se revisan la cabecera, la versión y que los
+ * tamaños de las secciones coincidan con el del archivo, lo que no depende
+ * del tamaño del grafo. El checksum y los invariantes de los datos (índices
+ * dentro de rango, filas ordenadas, simetría, etc.) recorren el archivo
+ * completo, así que solo se revisan si se pide; sin esa revisión, un
+ * snapshot con la cabecera correcta se considera confiable.
+ */
+
+namespace {
+
+constexpr char snapshot_magic[8] = {'T', 'A', 'R', 'E', 'A', '1', 'G', 'R'};
+constexpr std::uint32_t snapshot_version = 7;
+constexpr std::uint32_t snapshot_byte_order = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byte_order;
+    std::uint64_t node_count;
+    std::uint64_t edge_count;
+    std::uint64_t names_size;
+    std::uint32_t start;
+    std::uint32_t end;
+    std::uint32_t mode;
+    std::uint32_t weight_kind;
+    std::uint32_t has_coordinates;
+    std::uint32_t component_count;
+    std::uint64_t payload_size;
+    std::uint64_t checksum;
+    std::uint64_t source_size;
+    std::int64_t source_mtime;
+    std::uint64_t source_hash;
+    std::uint64_t dag_edge_count;
+    std::uint64_t hub_slot_count;
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0,
+              "Snapshot sections must stay 8-byte aligned");
+
+/**
+ * @brief Código con que se guarda en la cabecera el tipo de los pesos. El
+ * código de int es 0, de modo que los snapshots anteriores a que el tipo
+ * fuera configurable siguen siendo válidos.
+ */
+template <typename W>
+constexpr std::uint32_t weight_kind();
+
+template <>
+constexpr std::uint32_t weight_kind<int>() {
+    return 0;
+}
+
+template <>
+constexpr std::uint32_t weight_kind<std::uint16_t>() {
+    return 1;
+}
+
+template <>
+constexpr std::uint32_t weight_kind<std::uint32_t>() {
+    return 2;
+}
+
+template <>
+constexpr std::uint32_t weight_kind<std::uint64_t>() {
+    return 3;
+}
+
+template <>
+constexpr std::uint32_t weight_kind<float>() {
+    return 4;
+}
+
+std::uint64_t padded(std::uint64_t size) {
+    return (size + 7) & ~std::uint64_t{7};
+}
+
+/**
+ * @brief Calcula el tamaño de las secciones de un snapshot.
+ */
+template <typename W>
+std::uint64_t payload_size(const SnapshotHeader& header) {
+    const auto node_count = header.node_count;
+    const auto edge_count = header.edge_count;
+    const std::uint64_t component_count = header.component_count;
+
+    return 2 * padded((node_count + 1) * sizeof(std::uint64_t)) +
+           padded(edge_count * sizeof(NodeId)) +
+           padded(edge_count * sizeof(W)) +
+           padded(node_count * sizeof(int)) +
+           padded(node_count * sizeof(NodeId)) + padded(header.names_size) +
+           padded(node_count * sizeof(NodeId)) +
+           2 * padded(component_count * sizeof(NodeId)) +
+           padded((component_count + 1) * sizeof(std::uint64_t)) +
+           padded(header.dag_edge_count * sizeof(NodeId)) +
+           header.hub_slot_count * sizeof(FlatEdgeIndex::Slot) +
+           (header.has_coordinates != 0 ? node_count * sizeof(Point) : 0);
+}
+
+/**
+ * @brief Suma de verificación FNV-1a, aplicada sobre palabras de 64 bits en
+ * lugar de bytes para que verificar un archivo grande no domine la carga.
+ */
+class Checksum {
+private:
+    std::uint64_t m_hash = 0xcbf29ce484222325;
+
+public:
+    void update(const char* data, std::size_t size) {
+        for (std::size_t i = 0; i < size; i += sizeof(std::uint64_t)) {
+            std::uint64_t word = 0;
+            std::memcpy(&word, data + i, sizeof(word));
+            m_hash = (m_hash ^ word) * 0x100000001b3;
+        }
+    }
+
+    std::uint64_t value() const { return m_hash; }
+};
+
+/**
+ * @brief Agrega la cabecera al checksum, con el campo del checksum en 0.
+ */
+void update_header(Checksum& checksum, SnapshotHeader header) {
+    header.checksum = 0;
+    checksum.update(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+/**
+ * @brief Revisa que un arreglo de inicios de fila empiece en 0, no decrezca
+ * y termine en `total`.
+ */
+bool valid_offsets(ArrayView<std::uint64_t> offsets, std::uint64_t total) {
+    if (offsets.empty() || offsets[0] != 0 ||
+        offsets[offsets.size() - 1] != total) {
+        return false;
+    }
+
+    return std::is_sorted(std::cbegin(offsets), std::cend(offsets));
+}
+
+/**
+ * @brief Revisa que todos los identificadores de un arreglo sean nodos del
+ * grafo.
+ */
+bool valid_nodes(ArrayView<NodeId> nodes, std::uint64_t node_count) {
+    return std::all_of(std::cbegin(nodes), std::cend(nodes),
+                       [node_count](NodeId node) { return node < node_count; });
+}
+
+/**
+ * @brief Revisa que la tabla de aristas de grado alto tenga al menos una
+ * ranura libre (si no, una búsqueda fallida no terminaría) y que cada ranura
+ * ocupada apunte a su arista dentro de la fila de su origen.
+ */
+bool valid_hub_slots(ArrayView<FlatEdgeIndex::Slot> slots,
+                     ArrayView<std::uint64_t> offsets,
+                     ArrayView<NodeId> targets) {
+    bool has_free = slots.empty();
+    for (const auto& slot : slots) {
+        if (slot.key == FlatEdgeIndex::empty_key) {
+            has_free = true;
+            continue;
+        }
+
+        const auto from = slot.key >> 32;
+        const auto to = static_cast<NodeId>(slot.key);
+        if (from + 1 >= offsets.size() || slot.position < offsets[from] ||
+            slot.position >= offsets[from + 1] ||
+            targets[slot.position] != to) {
+            return false;
+        }
+    }
+
+    return has_free;
+}
+
+/**
+ * @brief Escribe una sección rellenada hasta un múltiplo de 8 bytes.
+ */
+template <typename T>
+void write_section(std::ostream& out, Checksum& checksum,
+                   ArrayView<T> section) {
+    const auto size = section.size() * sizeof(T);
+    const auto whole = size - size % sizeof(std::uint64_t);
+    const auto* bytes = reinterpret_cast<const char*>(section.data());
+
+    out.write(bytes, whole);
+    checksum.update(bytes, whole);
+
+    // La última palabra incompleta se rellena con ceros para que el checksum
+    // siempre recorra palabras completas.
+    if (whole < size) {
+        char tail[sizeof(std::uint64_t)] = {};
+        std::memcpy(tail, bytes + whole, size - whole);
+
+        out.write(tail, sizeof(tail));
+        checksum.update(tail, sizeof(tail));
+    }
+}
+
+/**
+ * @brief Obtiene una sección del archivo mapeado y avanza el cursor.
+ */
+template <typename T>
+ArrayView<T> read_section(const char*& cursor, std::uint64_t count) {
+    const auto* data = reinterpret_cast<const T*>(cursor);
+    cursor += padded(count * sizeof(T));
+
+    return {data, count};
+}
+
+}  // namespace
+
+/**
+ * @brief Guarda un grafo congelado en formato binario, junto con su índice de
+ * alcanzabilidad. Si el grafo no tiene el índice construido, se calcula
+ * solo para escribirlo.
+ * @param graph Grafo a guardar.
+ * @param path Ruta del archivo de salida.
+ * @param source Archivo de texto del que el snapshot es caché, o un
+ * SnapshotSource vacío si no lo es.
+ * @throws std::runtime_error si no se puede escribir el archivo.
+ */
+template <typename W>
+void write_snapshot(const BasicCsrGraph<W>& graph, const std::string& path,
+                    const SnapshotSource& source) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open " + path + " for writing");
+    }
+
+    std::optional<ReachabilityIndex> built;
+    const auto& reachability = graph.has_reachability()
+                                   ? graph.reachability()
+                                   : built.emplace(graph);
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+    header.version = snapshot_version;
+    header.byte_order = snapshot_byte_order;
+    header.node_count = graph.vertex_count();
+    header.edge_count = graph.edge_count();
+    header.names_size = graph.names().size();
+    header.start = graph.m_start;
+    header.end = graph.m_end;
+    header.mode = graph.m_mode == GraphMode::undirected ? 1 : 0;
+    header.weight_kind = weight_kind<W>();
+    header.has_coordinates = graph.has_coordinates() ? 1 : 0;
+    header.component_count =
+        static_cast<std::uint32_t>(reachability.component_count());
+    header.dag_edge_count = reachability.dag_targets().size();
+    header.hub_slot_count = graph.m_hub_edges.slots().size();
+    header.payload_size = payload_size<W>(header);
+    header.source_size = source.size;
+    header.source_mtime = source.mtime;
+    header.source_hash = source.hash;
+
+    // La cabecera se escribe dos veces: primero para reservar su espacio y,
+    // una vez calculado el checksum, con su valor definitivo.
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    Checksum checksum;
+    update_header(checksum, header);
+    write_section(out, checksum, graph.offsets());
+    write_section(out, checksum, graph.name_offsets());
+    write_section(out, checksum, graph.targets());
+    write_section(out, checksum, graph.weights());
+    write_section(out, checksum, graph.heuristics());
+    write_section(out, checksum, graph.name_order());
+    write_section(out, checksum, graph.names());
+    write_section(out, checksum, reachability.components());
+    write_section(out, checksum, reachability.weak_components());
+    write_section(out, checksum, reachability.levels());
+    write_section(out, checksum, reachability.dag_offsets());
+    write_section(out, checksum, reachability.dag_targets());
+    write_section(out, checksum, graph.m_hub_edges.slots());
+    write_section(out, checksum, graph.coordinates());
+
+    header.checksum = checksum.value();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!out.flush()) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+}
+
+/**
+ * @brief Abre un grafo guardado con write_snapshot. El archivo se mapea en
+ * memoria y el grafo, con su índice de alcanzabilidad y su tabla de aristas
+ * de grado alto, apunta directamente a él, sin copiar ni reconstruir nada:
+ * sin `verify`, abrirlo no depende del tamaño del grafo.
+ * @param path Ruta del archivo.
+ * @param verify Si es true, además se verifican el checksum y los
+ * invariantes de los datos, recorriendo el archivo completo.
+ * @return Grafo almacenado en el archivo.
+ * @throws std::runtime_error si el archivo no es un snapshot válido, es de
+ * otra versión, tiene pesos de otro tipo o está dañado.
+ */
+template <typename W>
+BasicCsrGraph<W> read_snapshot(const std::string& path, bool verify) {
+    auto file = std::make_shared<MappedFile>(path);
+
+    if (file->size() < sizeof(SnapshotHeader)) {
+        throw std::runtime_error(path + " is not a graph snapshot");
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+
+    if (std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) !=
+        0) {
+        throw std::runtime_error(path + " is not a graph snapshot");
+    }
+
+    if (header.version != snapshot_version) {
+        throw std::runtime_error(path + " has unsupported snapshot version " +
+                                 std::to_string(header.version));
+    }
+
+    if (header.byte_order != snapshot_byte_order) {
+        throw std::runtime_error(path + " was written with another byte order");
+    }
+
+    if (header.mode > 1) {
+        throw std::runtime_error(path + " is corrupted (bad graph mode)");
+    }
+
+    if (header.weight_kind != weight_kind<W>()) {
+        throw std::runtime_error(path + " has weights of another type");
+    }
+
+    if (header.has_coordinates > 1) {
+        throw std::runtime_error(path + " is corrupted (bad coordinates flag)");
+    }
+
+    // Ninguna sección puede ser más grande que el archivo; revisarlo antes
+    // evita que el cálculo del tamaño se desborde con conteos absurdos.
+    if (header.node_count >= Graph::invalid_node) {
+        throw std::runtime_error(path + " is corrupted (bad node count)");
+    }
+
+    // Cada nodo está en exactamente una componente.
+    if (header.component_count > header.node_count ||
+        (header.component_count == 0) != (header.node_count == 0)) {
+        throw std::runtime_error(path +
+                                 " is corrupted (bad component count)");
+    }
+
+    const auto hub_slots = header.hub_slot_count;
+    if (hub_slots != 0 && (hub_slots & (hub_slots - 1)) != 0) {
+        throw std::runtime_error(path + " is corrupted (bad hub table size)");
+    }
+
+    if (header.edge_count > file->size() || header.names_size > file->size() ||
+        header.dag_edge_count > file->size() || hub_slots > file->size() ||
+        header.payload_size != payload_size<W>(header) ||
+        file->size() != sizeof(header) + header.payload_size) {
+        throw std::runtime_error(path + " is truncated");
+    }
+
+    // El origen y el destino pueden faltar (invalid_node).
+    const auto valid_terminal = [&header](NodeId node) {
+        return node < header.node_count || node == Graph::invalid_node;
+    };
+
+    if (!valid_terminal(header.start) || !valid_terminal(header.end)) {
+        throw std::runtime_error(path + " is corrupted (bad start or end)");
+    }
+
+    const char* cursor = file->data() + sizeof(header);
+
+    if (verify) {
+        Checksum checksum;
+        update_header(checksum, header);
+        checksum.update(cursor, header.payload_size);
+        if (checksum.value() != header.checksum) {
+            throw std::runtime_error(path +
+                                     " is corrupted (checksum mismatch)");
+        }
+    }
+
+    BasicCsrGraph<W> graph;
+    graph.m_offsets =
+        read_section<std::uint64_t>(cursor, header.node_count + 1);
+    graph.m_name_offsets =
+        read_section<std::uint64_t>(cursor, header.node_count + 1);
+    graph.m_targets = read_section<NodeId>(cursor, header.edge_count);
+    graph.m_weights = read_section<W>(cursor, header.edge_count);
+    graph.m_heuristics = read_section<int>(cursor, header.node_count);
+    graph.m_name_order = read_section<NodeId>(cursor, header.node_count);
+    graph.m_names = read_section<char>(cursor, header.names_size);
+
+    ReachabilityIndex reachability;
+    reachability.m_component =
+        read_section<NodeId>(cursor, header.node_count);
+    reachability.m_weak = read_section<NodeId>(cursor, header.component_count);
+    reachability.m_level =
+        read_section<NodeId>(cursor, header.component_count);
+    reachability.m_dag_offsets =
+        read_section<std::uint64_t>(cursor, header.component_count + 1);
+    reachability.m_dag_targets =
+        read_section<NodeId>(cursor, header.dag_edge_count);
+
+    const auto hub_view =
+        read_section<FlatEdgeIndex::Slot>(cursor, header.hub_slot_count);
+
+    if (header.has_coordinates != 0) {
+        graph.m_coordinates = read_section<Point>(cursor, header.node_count);
+    }
+    graph.m_start = header.start;
+    graph.m_end = header.end;
+    graph.m_mode =
+        header.mode == 1 ? GraphMode::undirected : GraphMode::directed;
+
+    // El checksum no protege de un archivo armado a propósito, así que al
+    // verificar también se revisa que todo índice caiga dentro de los
+    // arreglos, que las filas estén ordenadas por destino (para la búsqueda
+    // binaria de aristas), que `name_order` esté ordenado por nombre (para
+    // la de nombres) y que un grafo no dirigido sea simétrico.
+    if (verify) {
+        if (!valid_offsets(graph.m_offsets, header.edge_count) ||
+            !valid_offsets(graph.m_name_offsets, header.names_size)) {
+            throw std::runtime_error(path + " is corrupted (bad offsets)");
+        }
+
+        if (!valid_nodes(graph.m_targets, header.node_count) ||
+            !valid_nodes(graph.m_name_order, header.node_count)) {
+            throw std::runtime_error(path + " is corrupted (bad node id)");
+        }
+
+        const auto targets = std::cbegin(graph.m_targets);
+        for (NodeId node = 0; node < header.node_count; ++node) {
+            if (!std::is_sorted(targets + graph.m_offsets[node],
+                                targets + graph.m_offsets[node + 1])) {
+                throw std::runtime_error(path +
+                                         " is corrupted (unsorted row)");
+            }
+        }
+
+        const auto& order = graph.m_name_order;
+        for (std::size_t i = 1; i < order.size(); ++i) {
+            if (graph.node_name(order[i]) < graph.node_name(order[i - 1])) {
+                throw std::runtime_error(
+                    path + " is corrupted (unsorted name order)");
+            }
+        }
+
+        if (graph.m_mode == GraphMode::undirected && !graph.is_symmetric()) {
+            throw std::runtime_error(path +
+                                     " is corrupted (asymmetric graph)");
+        }
+
+        if (!valid_hub_slots(hub_view, graph.m_offsets, graph.m_targets)) {
+            throw std::runtime_error(path + " is corrupted (bad hub table)");
+        }
+
+        const auto components = header.component_count;
+        if (!valid_offsets(reachability.m_dag_offsets,
+                           header.dag_edge_count) ||
+            !valid_nodes(reachability.m_component, components) ||
+            !valid_nodes(reachability.m_weak, components) ||
+            !valid_nodes(reachability.m_dag_targets, components)) {
+            throw std::runtime_error(
+                path + " is corrupted (bad reachability index)");
+        }
+    }
+
+    reachability.m_storage = file;
+    graph.m_reachability =
+        std::make_shared<const ReachabilityIndex>(std::move(reachability));
+    graph.m_hub_edges = FlatEdgeIndex(hub_view, file);
+    graph.m_storage = std::move(file);
+
+    return graph;
+}
+
+template void write_snapshot(const BasicCsrGraph<int>&, const std::string&,
+                             const SnapshotSource&);
+template void write_snapshot(const BasicCsrGraph<std::uint16_t>&,
+                             const std::string&, const SnapshotSource&);
+template void write_snapshot(const BasicCsrGraph<std::uint32_t>&,
+                             const std::string&, const SnapshotSource&);
+template void write_snapshot(const BasicCsrGraph<std::uint64_t>&,
+                             const std::string&, const SnapshotSource&);
+template void write_snapshot(const BasicCsrGraph<float>&, const std::string&,
+                             const SnapshotSource&);
+
+template BasicCsrGraph<int> read_snapshot<int>(const std::string&, bool);
+template BasicCsrGraph<std::uint16_t> read_snapshot<std::uint16_t>(
+    const std::string&, bool);
+template BasicCsrGraph<std::uint32_t> read_snapshot<std::uint32_t>(
+    const std::string&, bool);
+template BasicCsrGraph<std::uint64_t> read_snapshot<std::uint64_t>(
+    const std::string&, bool);
+template BasicCsrGraph<float> read_snapshot<float>(const std::string&,
+                                                   bool);
+
+/**
+ * @brief Revisa si un archivo es un snapshot binario, mirando solo su firma.
+ * @param path Ruta del archivo.
+ * @return true si el archivo comienza con la firma de un snapshot.
+ */
+bool is_snapshot(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+
+    char magic[sizeof(snapshot_magic)];
+    if (!in.read(magic, sizeof(magic))) {
+        return false;
+    }
+
+    return std::memcmp(magic, snapshot_magic, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Lee la cabecera de un snapshot sin mapear ni verificar el resto del
+ * archivo.
+ * @param path Ruta del archivo.
+ * @return Datos de la cabecera, o std::nullopt si el archivo no existe, no
+ * es un snapshot o es de otra versión.
+ */
+std::optional<SnapshotInfo> read_snapshot_info(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+
+    SnapshotHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, snapshot_magic, sizeof(snapshot_magic)) !=
+            0 ||
+        header.version != snapshot_version ||
+        header.byte_order != snapshot_byte_order || header.mode > 1) {
+        return std::nullopt;
+    }
+
+    return SnapshotInfo{
+        header.mode == 1 ? GraphMode::undirected : GraphMode::directed,
+        {header.source_size, header.source_mtime, header.source_hash}};
+}
@@ -1,106 +1,205 @@
 #include "solvers/a-star.h"
 
-#include <limits>
+#include <algorithm>
 #include <map>
-#include <queue>
+
+#include "compressedgraph.h"
+#include "csrgraph.h"
 
 /**
  * @brief Resuelve el problema de encontrar el camino más corto entre dos nodos
- * utilizando el algoritmo A*.
+ * utilizando el algoritmo A*. Los costos, los padres y las expansiones se
+ * guardan en los arreglos por nodo del espacio de trabajo.
+ * @param workspace Espacio de trabajo de la búsqueda.
  */
-void AStarSolver::solve() {
-    static const auto comp = [](const GraphNode& lhs, const GraphNode& rhs) {
-        return lhs.heuristic > rhs.heuristic;
-    };
+template <typename G, typename H, template <typename> class Q>
+void AStarSolver<G, H, Q>::solve(workspace_type& workspace) {
+    using Traits = WeightTraits<typename G::weight_type>;
 
-    std::priority_queue<GraphNode, std::vector<GraphNode>, decltype(comp)>
-        frontier(comp);
-    std::unordered_map<std::string, std::string> came_from;
-    std::unordered_map<std::string, int> cost_so_far;
+    workspace.reset(m_graph.vertex_count());
+    // Cada entrada de la frontera es un par (prioridad, nodo).
+    auto& frontier = workspace.frontier();
 
-    // Agregamos el nodo inicial a la frontera.
-    frontier.push(m_graph.start());
+    const auto start = m_graph.start_id();
+    const auto end = m_graph.end_id();
 
-    const auto start_name = m_graph.start().name;
-    const auto end_name = m_graph.end().name;
+    // La prioridad de un nodo es su costo acumulado más la heurística.
+    const auto priority = [this](cost_type cost, NodeId node) {
+        return Traits::add(cost, static_cast<cost_type>(m_heuristic(node)));
+    };
+
+    // Agregamos el nodo inicial a la frontera.
+    workspace.reach(start, 0, start);
+    frontier.push(priority(0, start), start);
 
-    came_from[start_name] = start_name;
-    cost_so_far[start_name] = 0;
+    bool found = false;
 
     // Mientras la frontera no esté vacía...
     while (!frontier.empty()) {
         // Tomamos el nodo con menor costo.
-        const auto current = frontier.top();
-        frontier.pop();
+        const auto [key, current] = frontier.pop();
+        const auto current_cost = workspace.cost(current);
+
+        // Si el costo del nodo mejoró después de agregar esta entrada, hay
+        // otra más nueva en la frontera y esta se descarta. Con un montículo
+        // indexado esto no ocurre, porque la entrada se actualiza.
+        if (key != priority(current_cost, current)) {
+            continue;
+        }
+
+        workspace.expand(current);
 
         // Si el nodo actual es el nodo final, terminamos.
-        if (current.name == end_name) {
-            m_visit_count[current.name]++;
+        if (current == end) {
+            found = true;
             break;
         }
 
-        m_visit_count[current.name]++;
-
         // Recorremos los vecinos del nodo actual.
-        for (const auto [neighbor, weight] :
-             m_graph.get_neighbors(current.name)) {
-            const int new_cost = cost_so_far[current.name] + weight;
+        for (const auto [neighbor, weight] : m_graph.neighbors(current)) {
+            const auto new_cost = Traits::add(current_cost, weight);
 
             // Si el vecino no ha sido visitado o el costo actual es menor al
             // costo que se tenía hasta el momento, actualizamos el costo y
             // agregamos el vecino a la frontera.
-            if (cost_so_far.find(neighbor) == std::cend(cost_so_far) ||
-                new_cost < cost_so_far[neighbor]) {
-                cost_so_far[neighbor] = new_cost;
-                const int priority =
-                    new_cost + m_graph.get_node(neighbor).heuristic;
-                frontier.push({neighbor, priority});
-                came_from[neighbor] = current.name;
-
-                m_cost = new_cost;
+            if (!workspace.reached(neighbor) ||
+                new_cost < workspace.cost(neighbor)) {
+                workspace.reach(neighbor, new_cost, current);
+                frontier.push(priority(new_cost, neighbor), neighbor);
             }
         }
     }
 
+    if (!found) {
+        return;
+    }
+
     // Si encontramos un camino, lo ensamblamos.
-    std::string node = end_name;
-    while (node != start_name) {
+    m_cost = workspace.cost(end);
+
+    for (auto node = end; node != start; node = workspace.parent(node)) {
         m_path.push_back(node);
-        node = came_from[node];
     }
 
-    m_path.push_back(start_name);
+    m_path.push_back(start);
     std::reverse(std::begin(m_path), std::end(m_path));
+
+    // Las expansiones se copian solo para los nodos del camino, que son las
+    // que se informan. Con una heurística inconsistente un nodo se puede
+    // expandir más de una vez.
+    m_path_visits.reserve(m_path.size());
+    for (const auto node : m_path) {
+        m_path_visits.push_back(static_cast<int>(workspace.expansions(node)));
+    }
+}
+
+/**
+ * @brief Constructor. Define el grafo y la heurística a utilizar, y resuelve
+ * el problema con un espacio de trabajo propio.
+ * @param graph Grafo sobre el que se busca.
+ * @param heuristic Estimación del costo desde cada nodo hasta el destino.
+ */
+template <typename G, typename H, template <typename> class Q>
+AStarSolver<G, H, Q>::AStarSolver(const G& graph, H heuristic)
+    : m_graph(graph),
+      m_heuristic(std::move(heuristic)),
+      m_path(),
+      m_cost(0),
+      m_path_visits() {
+    workspace_type workspace;
+    solve(workspace);
 }
 
 /**
- * @brief Constructor. Define el grafo a utilizar y resuelve el problema.
+ * @brief Constructor. Define el grafo y la heurística a utilizar, y resuelve
+ * el problema reutilizando un espacio de trabajo, para no reservar memoria de
+ * nuevo en cada consulta.
+ * @param graph Grafo sobre el que se busca.
+ * @param heuristic Estimación del costo desde cada nodo hasta el destino.
+ * @param workspace Espacio de trabajo. Su contenido anterior se descarta.
  */
-AStarSolver::AStarSolver(const Graph& graph)
-    : m_graph(graph), m_path(), m_cost(0), m_visit_count() {
-    solve();
+template <typename G, typename H, template <typename> class Q>
+AStarSolver<G, H, Q>::AStarSolver(const G& graph, H heuristic,
+                                  workspace_type& workspace)
+    : m_graph(graph),
+      m_heuristic(std::move(heuristic)),
+      m_path(),
+      m_cost(0),
+      m_path_visits() {
+    solve(workspace);
 }
 
 /**
  * @brief Devuelve el camino encontrado.
  * @return El camino encontrado.
  */
-std::vector<std::string> AStarSolver::solution() const {
-    return m_path;
+template <typename G, typename H, template <typename> class Q>
+std::vector<std::string> AStarSolver<G, H, Q>::solution() const {
+    std::vector<std::string> path;
+    path.reserve(m_path.size());
+
+    for (const auto node : m_path) {
+        path.emplace_back(m_graph.node_name(node));
+    }
+
+    return path;
 }
 
 /**
  * @brief Devuelve el costo del camino encontrado.
  * @return El costo del camino encontrado.
  */
-int AStarSolver::cost() const {
+template <typename G, typename H, template <typename> class Q>
+typename AStarSolver<G, H, Q>::cost_type AStarSolver<G, H, Q>::cost() const {
     return m_cost;
 }
 
 /**
- * @brief Devuelve la cantidad de veces que se visitó cada nodo.
- * @return La cantidad de veces que se visitó cada nodo.
+ * @brief Devuelve la cantidad de veces que se expandió cada nodo del camino
+ * encontrado. El mapa se arma al pedirlo, y solo con los nodos del camino.
+ * @return La cantidad de veces que se expandió cada nodo del camino.
  */
-std::map<std::string, int> AStarSolver::visit_count() const {
-    return m_visit_count;
+template <typename G, typename H, template <typename> class Q>
+std::map<std::string, int> AStarSolver<G, H, Q>::visit_count() const {
+    std::map<std::string, int> visits;
+    for (std::size_t i = 0; i < m_path.size(); ++i) {
+        visits[std::string(m_graph.node_name(m_path[i]))] = m_path_visits[i];
+    }
+
+    return visits;
 }
+
+// Instancias para cada tipo de grafo, heurística y cola. La cola de Dial solo
+// admite claves enteras, así que no se instancia para pesos de punto flotante.
+#define INSTANTIATE_A_STAR(G, H)                    \
+    template class AStarSolver<G, H, IndexedHeap>;  \
+    template class AStarSolver<G, H, BinaryHeap>;   \
+    template class AStarSolver<G, H, FourAryHeap>;  \
+    template class AStarSolver<G, H, EightAryHeap>; \
+    template class AStarSolver<G, H, PairingHeap>;  \
+    template class AStarSolver<G, H, RadixHeap>
+
+#define INSTANTIATE_A_STAR_INTEGER(G, H) \
+    INSTANTIATE_A_STAR(G, H);            \
+    template class AStarSolver<G, H, DialQueue>
+
+#define INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE, G) \
+    INSTANTIATE(G, FileHeuristic<G>);                 \
+    INSTANTIATE(G, EuclideanHeuristic);               \
+    INSTANTIATE(G, ManhattanHeuristic);               \
+    INSTANTIATE(G, HaversineHeuristic)
+
+INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE_A_STAR_INTEGER, Graph);
+INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE_A_STAR_INTEGER, CsrGraph);
+INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE_A_STAR_INTEGER,
+                              BasicCsrGraph<std::uint16_t>);
+INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE_A_STAR_INTEGER,
+                              BasicCsrGraph<std::uint32_t>);
+INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE_A_STAR_INTEGER,
+                              BasicCsrGraph<std::uint64_t>);
+INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE_A_STAR, BasicCsrGraph<float>);
+INSTANTIATE_A_STAR_HEURISTICS(INSTANTIATE_A_STAR_INTEGER, CompressedGraph);
+
+#undef INSTANTIATE_A_STAR_HEURISTICS
+#undef INSTANTIATE_A_STAR_INTEGER
+#undef INSTANTIATE_A_STAR
@@ -2,16 +2,20 @@
 
 #include <map>
 #include <random>
-#include <stack>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "compressedgraph.h"
+#include "csrgraph.h"
+
 /**
  * @brief Genera un número pseudoaleatorio en [0, max).
  * @param max El límite superior del número aleatorio.
  * @return El número aleatorio generado.
  */
-int DFSSolver::random_pos(int max) const {
+template <typename G, typename H>
+int DFSSolver<G, H>::random_pos(int max) const {
     static std::random_device rd;
     static std::mt19937 gen(rd());
 
@@ -23,40 +27,47 @@ int DFSSolver::random_pos(int max) const {
 /**
  * @brief Función de utilidad para realizar una búsqueda en profundidad.
  * @param cur_node Nodo actual.
+ * @param cost Costo del camino desde el origen hasta el nodo actual.
  * @return El camino encontrado.
  */
-std::vector<std::string> DFSSolver::dfs(const std::string& cur_node) {
+template <typename G, typename H>
+std::vector<NodeId> DFSSolver<G, H>::dfs(NodeId cur_node, cost_type cost) {
     m_visited.insert(cur_node);
     m_path.push_back(cur_node);
-    m_visit_count[cur_node]++;
+    m_visits[cur_node]++;
 
-    if (cur_node == m_graph.end().name) {
+    if (cur_node == m_graph.end_id()) {
+        m_cost = cost;
         return m_path;
     }
 
     // Revisamos los vecinos del nodo actual y filtramos los que ya hemos
-    // visitado o que no cumplen con la condición de heurística.
-    std::vector<std::string> not_visited_neighbors;
-for (const auto& [neighbor, _] : m_graph.get_neighbors(cur_node)) {
+    // visitado o que no acercan al destino según la heurística.
+    const auto cur_heuristic = m_heuristic(cur_node);
+    std::vector<std::pair<NodeId, typename G::weight_type>>
+        not_visited_neighbors;
+    for (const auto& [neighbor, weight] : m_graph.neighbors(cur_node)) {
         if (m_visited.find(neighbor) != std::cend(m_visited)) {
             continue;
         }
 
-        const auto cur_heuristic = m_graph.get_heuristic(cur_node);
-        if (cur_heuristic <= m_graph.get_heuristic(neighbor)) {
+        if (cur_heuristic <= m_heuristic(neighbor)) {
             continue;
         }
 
-        not_visited_neighbors.push_back(neighbor);
+        not_visited_neighbors.push_back({neighbor, weight});
     }
 
     // Mientras haya vecinos no visitados, elegimos uno al azar y lo visitamos.
     while (!not_visited_neighbors.empty()) {
         const auto pos = random_pos(not_visited_neighbors.size());
-        const auto neighbor = not_visited_neighbors[pos];
+        const auto [neighbor, weight] = not_visited_neighbors[pos];
         not_visited_neighbors.erase(std::begin(not_visited_neighbors) + pos);
 
-        const auto path = dfs(neighbor);
+        // El costo se pasa hacia abajo en la recursión, así que al
+        // retroceder no hay nada que descontar.
+        const auto path = dfs(
+            neighbor, WeightTraits<typename G::weight_type>::add(cost, weight));
         if (!path.empty()) {
             return path;
         }
@@ -71,27 +82,29 @@ for (const auto& [neighbor, _] : m_graph.get_neighbors(cur_node)) {
  * @brief Resuelve el problema de encontrar el camino más corto entre dos nodos
  * utilizando el algoritmo DFS.
  */
-void DFSSolver::solve() {
-    dfs(m_graph.start().name);
-
-    if (m_path.empty()) {
-        return;
-    }
+template <typename G, typename H>
+void DFSSolver<G, H>::solve() {
+    dfs(m_graph.start_id(), 0);
 
-    for (std::size_t i = 0; i < m_path.size() - 1; ++i) {
-        m_cost += m_graph.get_cost(m_path[i], m_path[i + 1]);
+    for (const auto& [node, count] : m_visits) {
+        m_visit_count[std::string(m_graph.node_name(node))] = count;
     }
 }
 
 /**
- * @brief Constructor. Define el grafo a utilizar y resuelve el problema.
+ * @brief Constructor. Define el grafo y la heurística a utilizar, y resuelve
+ * el problema.
+ * @param graph Grafo sobre el que se busca.
+ * @param heuristic Estimación del costo desde cada nodo hasta el destino.
  */
-DFSSolver::DFSSolver(const Graph& graph)
+template <typename G, typename H>
+DFSSolver<G, H>::DFSSolver(const G& graph, H heuristic)
     : m_graph(graph),
+      m_heuristic(std::move(heuristic)),
       m_path(),
       m_cost(0),
       m_visited(),
-      m_stack(),
+      m_visits(),
       m_visit_count() {
     solve();
 }
@@ -100,15 +113,24 @@ DFSSolver::DFSSolver(const Graph& graph)
  * @brief Devuelve el camino encontrado.
  * @return El camino encontrado.
  */
-std::vector<std::string> DFSSolver::solution() const {
-    return m_path;
+template <typename G, typename H>
+std::vector<std::string> DFSSolver<G, H>::solution() const {
+    std::vector<std::string> path;
+    path.reserve(m_path.size());
+
+    for (const auto node : m_path) {
+        path.emplace_back(m_graph.node_name(node));
+    }
+
+    return path;
 }
 
 /**
  * @brief Devuelve el costo del camino encontrado.
  * @return El costo del camino encontrado.
  */
-int DFSSolver::cost() const {
+template <typename G, typename H>
+typename DFSSolver<G, H>::cost_type DFSSolver<G, H>::cost() const {
     return m_cost;
 }
 
@@ -116,6 +138,36 @@ int DFSSolver::cost() const {
  * @brief Devuelve la cantidad de veces que se visitó cada nodo.
  * @return La cantidad de veces que se visitó cada nodo.
  */
-std::map<std::string, int> DFSSolver::visit_count() const {
+template <typename G, typename H>
+std::map<std::string, int> DFSSolver<G, H>::visit_count() const {
     return m_visit_count;
 }
+
+template class DFSSolver<Graph>;
+template class DFSSolver<CsrGraph>;
+template class DFSSolver<BasicCsrGraph<std::uint16_t>>;
+template class DFSSolver<BasicCsrGraph<std::uint32_t>>;
+template class DFSSolver<BasicCsrGraph<std::uint64_t>>;
+template class DFSSolver<BasicCsrGraph<float>>;
+template class DFSSolver<CompressedGraph>;
+template class DFSSolver<Graph, EuclideanHeuristic>;
+template class DFSSolver<CsrGraph, EuclideanHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint16_t>, EuclideanHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint32_t>, EuclideanHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint64_t>, EuclideanHeuristic>;
+template class DFSSolver<BasicCsrGraph<float>, EuclideanHeuristic>;
+template class DFSSolver<CompressedGraph, EuclideanHeuristic>;
+template class DFSSolver<Graph, ManhattanHeuristic>;
+template class DFSSolver<CsrGraph, ManhattanHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint16_t>, ManhattanHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint32_t>, ManhattanHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint64_t>, ManhattanHeuristic>;
+template class DFSSolver<BasicCsrGraph<float>, ManhattanHeuristic>;
+template class DFSSolver<CompressedGraph, ManhattanHeuristic>;
+template class DFSSolver<Graph, HaversineHeuristic>;
+template class DFSSolver<CsrGraph, HaversineHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint16_t>, HaversineHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint32_t>, HaversineHeuristic>;
+template class DFSSolver<BasicCsrGraph<std::uint64_t>, HaversineHeuristic>;
+template class DFSSolver<BasicCsrGraph<float>, HaversineHeuristic>;
+template class DFSSolver<CompressedGraph, HaversineHeuristic>;
@@ -6,47 +6,77 @@
 #include <string>
 #include <vector>
 
+#include "compressedgraph.h"
+#include "csrgraph.h"
 #include "fmt/core.h"
 
 /**
  * @brief Resuelve el problema de encontrar el camino más corto entre dos nodos
  * utilizando un algoritmo greedy.
  */
-void GreedySolver::solve() {
-    const auto start_name = m_graph.start().name;
+template <typename G, typename H>
+void GreedySolver<G, H>::solve() {
+    const auto start = m_graph.start_id();
+    const auto end = m_graph.end_id();
 
-    m_path.push_back(start_name);
-    m_visit_count[start_name]++;
+    m_path.push_back(start);
+    m_visit_count[std::string(m_graph.node_name(start))]++;
 
-    auto cur_node = start_name;
-    while (cur_node != m_graph.end().name) {  // Mientras no lleguemos al nodo
-        // final...
-        const auto neighbors = m_graph.get_neighbors(cur_node);
+    // Las heurísticas de todos los vecinos se evalúan juntas, en un solo
+    // ciclo sobre arreglos contiguos.
+    std::vector<NodeId> ids;
+    std::vector<typename G::weight_type> weights;
+    std::vector<typename H::value_type> values;
+
+    auto cur_node = start;
+    while (cur_node != end) {  // Mientras no lleguemos al nodo final...
+        ids.clear();
+        weights.clear();
+        for (const auto [neighbor, weight] : m_graph.neighbors(cur_node)) {
+            ids.push_back(neighbor);
+            weights.push_back(weight);
+        }
+
+        // En un nodo sin salida no hay camino.
+        if (ids.empty()) {
+            m_path.clear();
+            m_cost = 0;
+            return;
+        }
+
+        values.resize(ids.size());
+        m_heuristic(ids.data(), ids.size(), values.data());
 
         // Tomamos el vecino con menor
         // heurística
-        std::string best_neighbor =
-            std::min_element(std::cbegin(neighbors), std::cend(neighbors),
-                             [this](const auto& lhs, const auto& rhs) {
-                                 return m_graph.get_heuristic(lhs.first) <
-                                        m_graph.get_heuristic(rhs.first);
-                             })
-                ->first;
+        const auto best = std::min_element(std::cbegin(values),
+                                           std::cend(values)) -
+                          std::cbegin(values);
+        const auto best_neighbor = ids[best];
+        const auto weight = weights[best];
 
         // Y lo agregamos al camino
-        m_cost += m_graph.get_cost(cur_node, best_neighbor);
+        m_cost = WeightTraits<typename G::weight_type>::add(m_cost, weight);
         m_path.push_back(best_neighbor);
-        m_visit_count[best_neighbor]++;
+        m_visit_count[std::string(m_graph.node_name(best_neighbor))]++;
 
         cur_node = best_neighbor;
     }
 }
 
 /**
- * @brief Constructor. Define el grafo a utilizar y resuelve el problema.
+ * @brief Constructor. Define el grafo y la heurística a utilizar, y resuelve
+ * el problema.
+ * @param graph Grafo sobre el que se busca.
+ * @param heuristic Estimación del costo desde cada nodo hasta el destino.
  */
-GreedySolver::GreedySolver(const Graph& graph)
-    : m_graph(graph), m_path(), m_cost(0), m_visit_count() {
+template <typename G, typename H>
+GreedySolver<G, H>::GreedySolver(const G& graph, H heuristic)
+    : m_graph(graph),
+      m_heuristic(std::move(heuristic)),
+      m_path(),
+      m_cost(0),
+      m_visit_count() {
     solve();
 }
 
@@ -54,15 +84,24 @@ GreedySolver::GreedySolver(const Graph& graph)
  * @brief Devuelve el camino encontrado.
  * @return El camino encontrado.
  */
-std::vector<std::string> GreedySolver::solution() const {
-    return m_path;
+template <typename G, typename H>
+std::vector<std::string> GreedySolver<G, H>::solution() const {
+    std::vector<std::string> path;
+    path.reserve(m_path.size());
+
+    for (const auto node : m_path) {
+        path.emplace_back(m_graph.node_name(node));
+    }
+
+    return path;
 }
 
 /**
  * @brief Devuelve el costo del camino encontrado.
  * @return El costo del camino encontrado.
  */
-int GreedySolver::cost() const {
+template <typename G, typename H>
+typename GreedySolver<G, H>::cost_type GreedySolver<G, H>::cost() const {
     return m_cost;
 }
 
@@ -70,6 +109,36 @@ int GreedySolver::cost() const {
  * @brief Devuelve la cantidad de veces que se visitó cada nodo.
  * @return La cantidad de veces que se visitó cada nodo.
  */
-std::map<std::string, int> GreedySolver::visit_count() const {
+template <typename G, typename H>
+std::map<std::string, int> GreedySolver<G, H>::visit_count() const {
     return m_visit_count;
 }
+
+template class GreedySolver<Graph>;
+template class GreedySolver<CsrGraph>;
+template class GreedySolver<BasicCsrGraph<std::uint16_t>>;
+template class GreedySolver<BasicCsrGraph<std::uint32_t>>;
+template class GreedySolver<BasicCsrGraph<std::uint64_t>>;
+template class GreedySolver<BasicCsrGraph<float>>;
+template class GreedySolver<CompressedGraph>;
+template class GreedySolver<Graph, EuclideanHeuristic>;
+template class GreedySolver<CsrGraph, EuclideanHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint16_t>, EuclideanHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint32_t>, EuclideanHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint64_t>, EuclideanHeuristic>;
+template class GreedySolver<BasicCsrGraph<float>, EuclideanHeuristic>;
+template class GreedySolver<CompressedGraph, EuclideanHeuristic>;
+template class GreedySolver<Graph, ManhattanHeuristic>;
+template class GreedySolver<CsrGraph, ManhattanHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint16_t>, ManhattanHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint32_t>, ManhattanHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint64_t>, ManhattanHeuristic>;
+template class GreedySolver<BasicCsrGraph<float>, ManhattanHeuristic>;
+template class GreedySolver<CompressedGraph, ManhattanHeuristic>;
+template class GreedySolver<Graph, HaversineHeuristic>;
+template class GreedySolver<CsrGraph, HaversineHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint16_t>, HaversineHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint32_t>, HaversineHeuristic>;
+template class GreedySolver<BasicCsrGraph<std::uint64_t>, HaversineHeuristic>;
+template class GreedySolver<BasicCsrGraph<float>, HaversineHeuristic>;
+template class GreedySolver<CompressedGraph, HaversineHeuristic>;
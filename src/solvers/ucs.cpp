@@ -2,116 +2,183 @@
 
 #include <fmt/core.h>
 
-#include <deque>
+#include <algorithm>
 #include <map>
-#include <queue>
-#include <random>
-#include <stack>
 #include <string>
-#include <tuple>
 #include <vector>
 
+#include "compressedgraph.h"
+#include "csrgraph.h"
+
 /**
  * @brief Resuelve el problema de encontrar el camino más corto entre dos nodos
- * utilizando el algoritmo de búsqueda de costo uniforme.
+ * utilizando el algoritmo de búsqueda de costo uniforme (Dijkstra).
+ *
+ * Las distancias, los predecesores y las expansiones se guardan en los
+ * arreglos por nodo del espacio de trabajo, que se reutiliza entre consultas.
+ * Cuando la distancia de un nodo mejora, un montículo indexado baja la clave
+ * de su entrada; con las demás colas el nodo queda varias veces en la
+ * frontera, y las entradas viejas se descartan al sacarlas porque su costo ya
+ * no coincide con la distancia del nodo.
+ * @param workspace Espacio de trabajo de la búsqueda.
  */
-void UCSSolver::solve() {
-    static const auto comp =
-        [](const std::tuple<std::string, std::string, int>& lhs,
-           const std::tuple<std::string, std::string, int>& rhs) {
-            return std::get<2>(lhs) > std::get<2>(rhs);
-        };
-
-    std::priority_queue<std::tuple<std::string, std::string, int>,
-                        std::vector<std::tuple<std::string, std::string, int>>,
-                        decltype(comp)>
-        frontier(comp);
-    std::set<std::string> expanded;
-    std::map<std::string, std::string> parent;
-
-    const auto start_name = m_graph.start().name;
-    const auto end_name = m_graph.end().name;
+template <typename G, template <typename> class Q>
+void UCSSolver<G, Q>::solve(workspace_type& workspace) {
+    using Traits = WeightTraits<typename G::weight_type>;
+
+    workspace.reset(m_graph.vertex_count());
+    // Cada entrada de la frontera es (costo acumulado, nodo).
+    auto& frontier = workspace.frontier();
+
+    const auto start = m_graph.start_id();
+    const auto end = m_graph.end_id();
 
     // Agregamos el nodo inicial a la frontera.
-    frontier.push(std::make_tuple(start_name, start_name, 0));
+    workspace.reach(start, 0, start);
+    frontier.push(0, start);
 
-    m_visit_count[start_name]++;
+    bool found = false;
 
     // Mientras la frontera no esté vacía...
     while (!frontier.empty()) {
         // Tomamos el nodo con menor costo.
-        const auto [cur_node, prev_node, cost] = frontier.top();
-        frontier.pop();
+        const auto [cost, cur_node] = frontier.pop();
 
-        // Si el nodo actual es el nodo final, salimos del ciclo.
-        if (cur_node == end_name) {
-            parent[cur_node] = prev_node;
-            m_visit_count[cur_node]++;
+        // Si la entrada quedó obsoleta, el nodo ya se expandió con un costo
+        // menor. Con un montículo indexado esto no ocurre, porque mejorar la
+        // distancia baja la clave de la entrada existente.
+        if (cost != workspace.cost(cur_node)) {
+            continue;
+        }
+
+        workspace.expand(cur_node);
 
+        // Si el nodo actual es el nodo final, salimos del ciclo.
+        if (cur_node == end) {
+            found = true;
             break;
         }
 
-        // De no serlo, lo agregamos a los nodos expandidos.
-        expanded.insert(cur_node);
-        m_visit_count[cur_node]++;
-
-        // Recorremos los vecinos del nodo actual.
-        for (const auto& [neighbor, neighbor_cost] :
-             m_graph.get_neighbors(cur_node)) {
-            if (expanded.find(neighbor) != std::cend(expanded)) {
-                continue;
+        // Recorremos los vecinos del nodo actual y actualizamos los que
+        // mejoran su distancia.
+        for (const auto [neighbor, weight] : m_graph.neighbors(cur_node)) {
+            const auto total_cost = Traits::add(cost, weight);
+            if (!workspace.reached(neighbor) ||
+                total_cost < workspace.cost(neighbor)) {
+                workspace.reach(neighbor, total_cost, cur_node);
+                frontier.push(total_cost, neighbor);
             }
-
-            // Si no se ha expandido, lo agregamos a la frontera.
-            const int total_cost = cost + neighbor_cost;
-            frontier.push(std::make_tuple(neighbor, cur_node, total_cost));
-            parent[neighbor] = cur_node;
         }
     }
 
+    if (!found) {
+        return;
+    }
+
     // Si encontramos un camino, lo reconstruimos.
-    std::string node_name = end_name;
-    while (node_name != start_name) {
-        m_path.push_back(node_name);
-        node_name = parent[node_name];
+    m_cost = workspace.cost(end);
+
+    for (auto node = end; node != start; node = workspace.parent(node)) {
+        m_path.push_back(node);
     }
 
-    m_path.push_back(start_name);
+    m_path.push_back(start);
     std::reverse(std::begin(m_path), std::end(m_path));
 
-    for (std::size_t i = 0; i < m_path.size() - 1; i++) {
-        m_cost += m_graph.get_cost(m_path[i], m_path[i + 1]);
+    // Las expansiones se copian solo para los nodos del camino, que son las
+    // que se informan; el espacio de trabajo puede usarse en otra consulta.
+    // Cada nodo se expande a lo más una vez.
+    m_path_visits.reserve(m_path.size());
+    for (const auto node : m_path) {
+        m_path_visits.push_back(static_cast<int>(workspace.expansions(node)));
     }
 }
 
 /**
- * @brief Constructor. Define el grafo a utilizar y resuelve el problema.
+ * @brief Constructor. Define el grafo a utilizar y resuelve el problema con
+ * un espacio de trabajo propio.
+ */
+template <typename G, template <typename> class Q>
+UCSSolver<G, Q>::UCSSolver(const G& graph)
+    : m_graph(graph), m_path(), m_cost(0), m_path_visits() {
+    workspace_type workspace;
+    solve(workspace);
+}
+
+/**
+ * @brief Constructor. Define el grafo a utilizar y resuelve el problema
+ * reutilizando un espacio de trabajo, para no reservar memoria de nuevo en
+ * cada consulta.
+ * @param graph Grafo sobre el que se busca.
+ * @param workspace Espacio de trabajo. Su contenido anterior se descarta.
  */
-UCSSolver::UCSSolver(const Graph& graph)
-    : m_graph(graph), m_path(), m_cost(0), m_visit_count() {
-    solve();
+template <typename G, template <typename> class Q>
+UCSSolver<G, Q>::UCSSolver(const G& graph, workspace_type& workspace)
+    : m_graph(graph), m_path(), m_cost(0), m_path_visits() {
+    solve(workspace);
 }
 
 /**
  * @brief Devuelve el camino encontrado.
  * @return El camino encontrado.
  */
-std::vector<std::string> UCSSolver::solution() const {
-    return m_path;
+template <typename G, template <typename> class Q>
+std::vector<std::string> UCSSolver<G, Q>::solution() const {
+    std::vector<std::string> path;
+    path.reserve(m_path.size());
+
+    for (const auto node : m_path) {
+        path.emplace_back(m_graph.node_name(node));
+    }
+
+    return path;
 }
 
 /**
  * @brief Devuelve el costo del camino encontrado.
  * @return El costo del camino encontrado.
  */
-int UCSSolver::cost() const {
+template <typename G, template <typename> class Q>
+typename UCSSolver<G, Q>::cost_type UCSSolver<G, Q>::cost() const {
     return m_cost;
 }
 
 /**
- * @brief Devuelve la cantidad de veces que se visitó cada nodo.
- * @return La cantidad de veces que se visitó cada nodo.
+ * @brief Devuelve la cantidad de veces que se expandió cada nodo del camino
+ * encontrado. El mapa se arma al pedirlo, y solo con los nodos del camino.
+ * @return La cantidad de veces que se expandió cada nodo del camino.
  */
-std::map<std::string, int> UCSSolver::visit_count() const {
-    return m_visit_count;
+template <typename G, template <typename> class Q>
+std::map<std::string, int> UCSSolver<G, Q>::visit_count() const {
+    std::map<std::string, int> visits;
+    for (std::size_t i = 0; i < m_path.size(); ++i) {
+        visits[std::string(m_graph.node_name(m_path[i]))] = m_path_visits[i];
+    }
+
+    return visits;
 }
+
+// Instancias para cada tipo de grafo y cola. La cola de Dial solo admite
+// claves enteras, así que no se instancia para pesos de punto flotante.
+#define INSTANTIATE_UCS(G)                    \
+    template class UCSSolver<G, IndexedHeap>;  \
+    template class UCSSolver<G, BinaryHeap>;   \
+    template class UCSSolver<G, FourAryHeap>;  \
+    template class UCSSolver<G, EightAryHeap>; \
+    template class UCSSolver<G, PairingHeap>;  \
+    template class UCSSolver<G, RadixHeap>
+
+#define INSTANTIATE_UCS_INTEGER(G) \
+    INSTANTIATE_UCS(G);            \
+    template class UCSSolver<G, DialQueue>
+
+INSTANTIATE_UCS_INTEGER(Graph);
+INSTANTIATE_UCS_INTEGER(CsrGraph);
+INSTANTIATE_UCS_INTEGER(BasicCsrGraph<std::uint16_t>);
+INSTANTIATE_UCS_INTEGER(BasicCsrGraph<std::uint32_t>);
+INSTANTIATE_UCS_INTEGER(BasicCsrGraph<std::uint64_t>);
+INSTANTIATE_UCS(BasicCsrGraph<float>);
+INSTANTIATE_UCS_INTEGER(CompressedGraph);
+
+#undef INSTANTIATE_UCS_INTEGER
+#undef INSTANTIATE_UCS